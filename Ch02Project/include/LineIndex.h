@@ -0,0 +1,232 @@
+//: :LineIndex.h
+// Random access to the lines of a file of any
+// size without reading it into strings. The
+// start offset of every line is found once with
+// Newlines (see Newlines.h) and kept in an index
+// file next to it (file.lines by default). Later
+// opens map the index and scan nothing. If the
+// file has grown and its first and last indexed
+// bytes are unchanged, only the appended part is
+// scanned; any other change rebuilds the index.
+// (An edit in place that keeps the size, the
+// modification time and both ends isn't seen.)
+// Where the index can't be written it is kept in
+// memory.
+// Lines are string_views into the mapped file,
+// without their '\n', numbered from 0.
+#ifndef LINEINDEX_H
+#define LINEINDEX_H
+#include "MappedFile.h"
+#include "Newlines.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <sys/stat.h>
+
+class LineIndex {
+public:
+  enum Built {
+    opened, appended, rebuilt, inMemory
+  };
+private:
+  struct Header {
+    char magic[8];
+    std::uint64_t size; // Bytes of text indexed
+    std::uint64_t lines; // Offsets that follow
+    std::uint64_t mtime; // Nanoseconds
+    std::uint64_t endLength;
+    char head[64]; // First bytes indexed
+    char tail[64]; // Last bytes indexed
+  };
+  static const char* magic() { return "LINEIDX1"; }
+  std::unique_ptr<MappedFile> text, index;
+  std::vector<std::uint64_t> memory;
+  const std::uint64_t* starts;
+  std::size_t n;
+  std::size_t bytesScanned;
+  Built how;
+  static std::uint64_t mtime(const std::string& f) {
+    struct stat st;
+    if(stat(f.c_str(), &st) != 0) return 0;
+    return std::uint64_t(st.st_mtim.tv_sec) *
+      1000000000 + st.st_mtim.tv_nsec;
+  }
+  Header header(std::size_t size,
+    std::size_t lines, std::uint64_t time) const {
+    Header h;
+    std::memset(&h, 0, sizeof h);
+    std::memcpy(h.magic, magic(), sizeof h.magic);
+    h.size = size;
+    h.lines = lines;
+    h.mtime = time;
+    h.endLength = size < 64 ? size : 64;
+    std::memcpy(h.head, text->data(), h.endLength);
+    std::memcpy(h.tail, text->data() + size -
+      h.endLength, h.endLength);
+    return h;
+  }
+  // The last offset in an index of h.lines > 0:
+  static std::uint64_t
+  lastStart(const Header& h, const char* data) {
+    std::uint64_t last;
+    std::memcpy(&last, data + sizeof h +
+      (h.lines - 1) * 8, sizeof last);
+    return last;
+  }
+  // Can h's offsets (in data, indexBytes long)
+  // be kept for the text as it is now? A line
+  // has at least one byte, so h.lines is checked
+  // against h.size before it's multiplied.
+  bool usable(const Header& h, const char* data,
+    std::size_t indexBytes) const {
+    return std::memcmp(h.magic, magic(),
+        sizeof h.magic) == 0 &&
+      h.size <= text->size() &&
+      h.endLength == (h.size < 64 ? h.size : 64) &&
+      h.lines <= h.size &&
+      indexBytes - sizeof h == h.lines * 8 &&
+      (h.lines == 0 || lastStart(h, data) < h.size) &&
+      std::memcmp(h.head, text->data(),
+        h.endLength) == 0 &&
+      std::memcmp(h.tail, text->data() + h.size -
+        h.endLength, h.endLength) == 0;
+  }
+  // The start of every line beginning in
+  // [from, size), given in blocks to out:
+  template<class Out>
+  std::size_t scan(std::size_t from, Out out) {
+    const char* p = text->data();
+    std::size_t size = text->size();
+    std::vector<std::uint64_t> block;
+    block.reserve(8192);
+    std::size_t found = 0;
+    // The first line, or one after an indexed
+    // text that ended with '\n':
+    if(from < size &&
+      (from == 0 || p[from - 1] == '\n'))
+      block.push_back(from);
+    Newlines::each(p + from, size - from,
+      [&](std::size_t i) {
+        std::size_t next = from + i + 1;
+        if(next == size) return;
+        block.push_back(next);
+        if(block.size() == block.capacity()) {
+          found += block.size();
+          out(block);
+          block.clear();
+        }
+      });
+    found += block.size();
+    out(block);
+    bytesScanned += size - from;
+    return found;
+  }
+  bool write(const std::string& indexFile,
+    const Header* old, std::uint64_t time) {
+    std::FILE* f = std::fopen(indexFile.c_str(),
+      old ? "r+b" : "wb");
+    if(f == 0) return false;
+    std::size_t from = old ? old->size : 0;
+    std::size_t lines = old ? old->lines : 0;
+    // Offsets first, then the header that makes
+    // them count:
+    bool ok = std::fseek(f, long(sizeof(Header) +
+      lines * 8), SEEK_SET) == 0;
+    lines += scan(from,
+      [&](const std::vector<std::uint64_t>& b) {
+        ok = ok && std::fwrite(b.data(), 8,
+          b.size(), f) == b.size();
+      });
+    Header h = header(text->size(), lines, time);
+    ok = ok && std::fseek(f, 0, SEEK_SET) == 0 &&
+      std::fwrite(&h, sizeof h, 1, f) == 1;
+    return std::fclose(f) == 0 && ok;
+  }
+  bool map(const std::string& indexFile) {
+    index.reset(new MappedFile(indexFile));
+    if(index->fail() ||
+      index->size() < sizeof(Header)) return false;
+    Header h;
+    std::memcpy(&h, index->data(), sizeof h);
+    if(!usable(h, index->data(), index->size()) ||
+      h.size != text->size()) return false;
+    starts = reinterpret_cast<const std::uint64_t*>(
+      index->data() + sizeof h);
+    n = h.lines;
+    return true;
+  }
+  LineIndex(const LineIndex&);
+  void operator=(const LineIndex&);
+public:
+  LineIndex(const std::string& file,
+    std::string indexFile = "")
+    : starts(0), n(0), bytesScanned(0),
+      how(opened) {
+    if(indexFile.empty()) indexFile = file + ".lines";
+    text.reset(new MappedFile(file));
+    if(text->fail()) return;
+    std::uint64_t time = mtime(file);
+    Header h;
+    bool have = false;
+    {
+      MappedFile old(indexFile);
+      if(!old.fail() && old.size() >= sizeof h) {
+        std::memcpy(&h, old.data(), sizeof h);
+        have = usable(h, old.data(), old.size());
+      }
+    }
+    // Same size, other time: rewritten in place
+    if(have && h.size == text->size() &&
+      h.mtime != time) have = false;
+    if(have && h.size == text->size()) {
+      if(map(indexFile)) return;
+    } else if(have) {
+      how = appended;
+      if(write(indexFile, &h, time) &&
+        map(indexFile)) return;
+    }
+    how = rebuilt;
+    if(write(indexFile, 0, time) &&
+      map(indexFile)) return;
+    // Can't keep an index file:
+    how = inMemory;
+    index.reset();
+    memory.clear();
+    scan(0, [&](const std::vector<std::uint64_t>& b) {
+      memory.insert(memory.end(), b.begin(), b.end());
+    });
+    starts = memory.data();
+    n = memory.size();
+  }
+  bool fail() const { return text->fail(); }
+  std::size_t lines() const { return n; }
+  // Line i, without its '\n':
+  std::string_view line(std::size_t i) const {
+    std::size_t begin = starts[i];
+    std::size_t end = i + 1 < n ?
+      starts[i + 1] - 1 : text->size();
+    if(i + 1 == n && end > begin &&
+      text->data()[end - 1] == '\n') end--;
+    return std::string_view(text->data() + begin,
+      end - begin);
+  }
+  std::string_view operator[](std::size_t i) const {
+    return line(i);
+  }
+  // The whole file:
+  std::string_view contents() const {
+    return text->view();
+  }
+  // How this open found its index, and how much
+  // of the text it had to read:
+  Built built() const { return how; }
+  std::size_t scanned() const {
+    return bytesScanned;
+  }
+};
+#endif // LINEINDEX_H ///:~
@@ -0,0 +1,95 @@
+//: :Newlines.h
+// Finds the '\n's in a block of text 64 bytes at
+// a time, as a bitmask built with AVX2 or SSE2
+// where the CPU has them (see Words.h for the
+// choice) and plain C++ otherwise. count() adds
+// up the masks' bits; each() calls f(offset)
+// for every newline.
+#ifndef NEWLINES_H
+#define NEWLINES_H
+#include "Words.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+class Newlines {
+public:
+  typedef std::uint64_t (*MaskFn)(const char*);
+private:
+  static std::uint64_t maskScalar(const char* s) {
+    std::uint64_t m = 0;
+    for(int i = 0; i < 64; i++)
+      m |= std::uint64_t(s[i] == '\n') << i;
+    return m;
+  }
+#ifdef WORDS_X86
+  __attribute__((target("sse2")))
+  static std::uint64_t maskSSE2(const char* s) {
+    const __m128i nl = _mm_set1_epi8('\n');
+    std::uint64_t m = 0;
+    for(int i = 0; i < 4; i++) {
+      __m128i v = _mm_loadu_si128(
+        (const __m128i*)(s + 16 * i));
+      m |= std::uint64_t(unsigned(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(v, nl))))
+        << (16 * i);
+    }
+    return m;
+  }
+  __attribute__((target("avx2")))
+  static std::uint64_t maskAVX2(const char* s) {
+    const __m256i nl = _mm256_set1_epi8('\n');
+    std::uint64_t m = 0;
+    for(int i = 0; i < 2; i++) {
+      __m256i v = _mm256_loadu_si256(
+        (const __m256i*)(s + 32 * i));
+      m |= std::uint64_t(unsigned(
+        _mm256_movemask_epi8(
+          _mm256_cmpeq_epi8(v, nl)))) << (32 * i);
+    }
+    return m;
+  }
+#endif
+public:
+  static MaskFn maskFor(Words::Isa isa) {
+    Words::Isa have = Words::detect();
+    if(isa > have) isa = have;
+#ifdef WORDS_X86
+    if(isa == Words::avx2) return maskAVX2;
+    if(isa == Words::sse2) return maskSSE2;
+#endif
+    return maskScalar;
+  }
+  // f(i) for each text[i] == '\n', in order:
+  template<class F>
+  static void each(const char* text, std::size_t n,
+    F f, Words::Isa isa = Words::best) {
+    MaskFn mask = maskFor(isa);
+    std::size_t b = 0;
+    for(; b + 64 <= n; b += 64)
+      for(std::uint64_t m = mask(text + b); m;
+        m &= m - 1)
+        f(b + __builtin_ctzll(m));
+    for(; b < n; b++)
+      if(text[b] == '\n') f(b);
+  }
+  static std::size_t count(const char* text,
+    std::size_t n, Words::Isa isa = Words::best) {
+    MaskFn mask = maskFor(isa);
+    std::size_t total = 0, b = 0;
+    for(; b + 64 <= n; b += 64)
+      total += __builtin_popcountll(mask(text + b));
+    for(; b < n; b++)
+      total += text[b] == '\n';
+    return total;
+  }
+  // Lines as getline() reads them: a last line
+  // without its '\n' still counts.
+  static std::size_t lines(const char* text,
+    std::size_t n, Words::Isa isa = Words::best) {
+    if(n == 0) return 0;
+    return count(text, n, isa) +
+      (text[n - 1] != '\n');
+  }
+};
+#endif // NEWLINES_H ///:~
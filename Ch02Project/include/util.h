@@ -13,6 +13,8 @@
 #include <fstream>
 #include <vector>
 #include <cstring>
+#include <cstdio>
+#include <unistd.h>
 
 void printCwd();
 
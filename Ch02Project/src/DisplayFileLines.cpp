@@ -3,34 +3,32 @@
  *
  *  Created on: Jun 5, 2014
  *      Author: cvora
+ *
+ *  Usage: DisplayFileLines [file]
+ *  Shows the file a line at a time from the end.
+ *  The line offsets are kept in file.lines (see
+ *  LineIndex.h), so a huge file opens at once and
+ *  is never read into memory.
  */
 
-#include <string>
 #include <iostream>
-#include <fstream>
-#include <vector>
 #include "util.h"
+#include "LineIndex.h"
 using namespace std;
 
-int main() {
-  vector<string> v;
-  ifstream in("src/CirceArea.cpp");
-  string line;
-  string fileString;
-	if(in.fail())
+int main(int argc, char* argv[]) {
+  const char* fileName = argc > 1 ? argv[1] : "src/CirceArea.cpp";
+  LineIndex lines(fileName);
+	if(lines.fail())
 	{
 		cout<<"File not found "<<endl;
 		printCwd();
 	}else{
-
-	  while(getline(in, line))
-		v.push_back(line); // Add the line to the end
 	  // Add line numbers:
-	  for(int i = v.size()-1; i >=0; i--){
-		cout << i << ": " << v[i] << endl;
+	  for(size_t i = lines.lines(); i-- > 0; ){
+		cout << i << ": " << lines[i] << endl;
 		 cin.ignore();
 	  }
-	  cout<<fileString<<endl;
 	}
 } ///:~
 
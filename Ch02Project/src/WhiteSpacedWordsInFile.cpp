@@ -4,10 +4,13 @@
  *  Created on: Jun 5, 2014
  *      Author: cvora
  */
-#include <string>
+#include <string_view>
 #include <iostream>
-#include <fstream>
 #include <vector>
+#include <cstdio>
+#include <unistd.h>
+#include "MappedFile.h"
+#include "Words.h"
 using namespace std;
 
 void printCwd()
@@ -22,17 +25,17 @@ void printCwd()
 
 int main()
 {
-	vector<string> v;
-	ifstream in("src/CirceArea.cpp");
-	string line;
-	string currentWord;
+	vector<string_view> v;
+	MappedFile in("src/CirceArea.cpp");
+	string_view currentWord;
 
 	if(in.fail())
 	{
 		cout<<"File not found "<<endl;
 		printCwd();
 	}else{
-		while(in >> currentWord)
+		Words words(in.data(), in.size());
+		while(words >> currentWord)
 			v.push_back(currentWord);
 		for(unsigned int i = 0; i < v.size(); i++)
 			cout << i << ": " << v[i] << endl;
@@ -3,45 +3,80 @@
  *
  *  Created on: Jun 5, 2014
  *      Author: cvora
+ *
+ *  Usage: WordCountInFile [file [word | -top K |
+ *         -keywords listFile [-offsets]]]
+ *  Counts one word (radius by default) on every
+ *  core, or with -top lists the K most frequent
+ *  words, or with -keywords counts every word in
+ *  listFile in one pass, and with -offsets lists
+ *  where each was found. Link with -pthread.
  */
 
 #include <string>
+#include <string_view>
 #include <iostream>
-#include <fstream>
 #include <vector>
-#include <cstring>
+#include <cstdlib>
 #include "util.h"
+#include "MappedFile.h"
+#include "WordCount.h"
+#include "Keywords.h"
+#include "Words.h"
 using namespace std;
 
 
-int main()
+int main(int argc, char* argv[])
 {
-	ifstream in("src/CirceArea.cpp");
-	string line;
-	string currentWord;
-	string wordToFind = "radius";
-	int wordCount = 0;
-	vector<string> v;
+	const char* fileName = argc > 1 ? argv[1] : "src/CirceArea.cpp";
+	string_view wordToFind = "radius";
+	int top = 0;
+	const char* keywordFile = 0;
+	bool offsets = false;
+	if(argc > 2 && string_view(argv[2]) == "-top")
+		top = argc > 3 ? atoi(argv[3]) : 10;
+	else if(argc > 3 && string_view(argv[2]) == "-keywords"){
+		keywordFile = argv[3];
+		offsets = argc > 4 && string_view(argv[4]) == "-offsets";
+	}else if(argc > 2)
+		wordToFind = argv[2];
+	MappedFile in(fileName);
 
 	if(in.fail())
 	{
 		cout<<"File not found "<<endl;
 		printCwd();
-	}else{
-		while(in >> currentWord)
-		{
-			if(!strcmp(currentWord.c_str(),wordToFind.c_str())){
-				wordCount++;
-			}
-			v.push_back(currentWord);
+	}else if(keywordFile){
+		MappedFile list(keywordFile);
+		if(list.fail()){
+			cout<<"File not found "<<keywordFile<<endl;
+			return 1;
 		}
-		cout << "WORD COUNT FOR " << wordToFind << " is: " <<wordCount<< endl;
+		vector<string> keywords;
+		Words listWords(list.data(), list.size());
+		string_view keyword;
+		while(listWords >> keyword)
+			keywords.push_back(string(keyword));
+		Keywords matcher(keywords);
+		vector<Keywords::Match> matches;
+		vector<long> counts = matcher.count(in.data(), in.size(),
+			offsets ? &matches : 0);
+		for(unsigned int i = 0; i < keywords.size(); i++)
+			cout << "WORD COUNT FOR " << keywords[i] << " is: "
+				<< counts[i] << endl;
+		for(unsigned int i = 0; i < matches.size(); i++)
+			cout << matches[i].offset << ": "
+				<< keywords[matches[i].keyword] << endl;
+	}else if(top > 0){
+		WordCount count(in.data(), in.size());
+		cout << count.total() << " words, " << count.distinct()
+			<< " different" << endl;
+		vector<WordCount::Freq> v = count.top(top);
 		for(unsigned int i = 0; i < v.size(); i++)
-			cout << i << ": " << v[i] << endl;
+			cout << i << ": " << v[i].first << " " << v[i].second << endl;
+	}else{
+		long wordCount = WordCount::occurrences(in.data(), in.size(),
+			wordToFind);
+		cout << "WORD COUNT FOR " << wordToFind << " is: " <<wordCount<< endl;
 	}
 }
-
-
-
-
-
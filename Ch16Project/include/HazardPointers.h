@@ -0,0 +1,134 @@
+/*
+ * HazardPointers.h
+ *
+ *  Safe memory reclamation for lock-free
+ *  containers. Before a thread dereferences a
+ *  shared node it publishes the node's address
+ *  in its hazard slot; a removed node is only
+ *  retired, and is deleted once no slot holds
+ *  its address.
+ */
+
+#ifndef HAZARDPOINTERS_H_
+#define HAZARDPOINTERS_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+#include "require.h"
+
+class HazardPointers {
+public:
+  enum { maxThreads = 256, scanThreshold = 128 };
+  struct Slot {
+    std::atomic<bool> used;
+    std::atomic<void*> hazard;
+    char pad[64 - sizeof(bool) - sizeof(void*)];
+  };
+private:
+  struct Retired {
+    void* p;
+    void (*destroy)(void*);
+  };
+  // One per thread: its slot and its nodes that
+  // are waiting for reclamation
+  struct ThreadRecord {
+    Slot* slot;
+    std::vector<Retired> retired;
+    ThreadRecord() : slot(instance().acquire()) {}
+    ~ThreadRecord() {
+      HazardPointers& hp = instance();
+      slot->hazard.store(0);
+      hp.scan(retired);
+      hp.orphan(retired);
+      slot->used.store(false);
+    }
+  };
+  Slot slots[maxThreads];
+  std::mutex orphanLock;
+  std::vector<Retired> orphans; // From exited threads
+  HazardPointers() {
+    for(int i = 0; i < maxThreads; i++) {
+      slots[i].used.store(false);
+      slots[i].hazard.store(0);
+    }
+  }
+  ~HazardPointers() { // Process exit: no readers
+    for(std::size_t i = 0; i < orphans.size(); i++)
+      orphans[i].destroy(orphans[i].p);
+  }
+  HazardPointers(const HazardPointers&);
+  void operator=(const HazardPointers&);
+  Slot* acquire() {
+    for(int i = 0; i < maxThreads; i++) {
+      bool expected = false;
+      if(!slots[i].used.load() &&
+        slots[i].used.compare_exchange_strong(
+          expected, true))
+        return &slots[i];
+    }
+    require(false, "HazardPointers: too many threads");
+    return 0;
+  }
+  // Delete every retired node no slot protects:
+  void scan(std::vector<Retired>& retired) {
+    {
+      std::unique_lock<std::mutex> lock(orphanLock,
+        std::try_to_lock);
+      if(lock && !orphans.empty()) {
+        retired.insert(retired.end(),
+          orphans.begin(), orphans.end());
+        orphans.clear();
+      }
+    }
+    std::vector<void*> live;
+    for(int i = 0; i < maxThreads; i++) {
+      void* p = slots[i].hazard.load();
+      if(p) live.push_back(p);
+    }
+    std::sort(live.begin(), live.end());
+    std::size_t kept = 0;
+    for(std::size_t i = 0; i < retired.size(); i++)
+      if(std::binary_search(live.begin(), live.end(),
+        retired[i].p))
+        retired[kept++] = retired[i];
+      else
+        retired[i].destroy(retired[i].p);
+    retired.resize(kept);
+  }
+  void orphan(std::vector<Retired>& retired) {
+    if(retired.empty()) return;
+    std::lock_guard<std::mutex> lock(orphanLock);
+    orphans.insert(orphans.end(),
+      retired.begin(), retired.end());
+    retired.clear();
+  }
+  static ThreadRecord& record() {
+    static thread_local ThreadRecord r;
+    return r;
+  }
+public:
+  static HazardPointers& instance() {
+    static HazardPointers hp;
+    return hp;
+  }
+  // The calling thread's hazard slot:
+  static std::atomic<void*>& hazard() {
+    return record().slot->hazard;
+  }
+  template<class Node> static void retire(Node* n) {
+    ThreadRecord& r = record();
+    Retired rt = { n, &destroy<Node> };
+    r.retired.push_back(rt);
+    if(r.retired.size() >= scanThreshold)
+      instance().scan(r.retired);
+  }
+private:
+  template<class Node> static void destroy(void* p) {
+    delete static_cast<Node*>(p);
+  }
+};
+
+#endif /* HAZARDPOINTERS_H_ */
@@ -0,0 +1,161 @@
+/*
+ * LockFreeStack.h
+ *
+ *  Treiber stack with the push/pop/peek and
+ *  iterator interface of TStack2.h, safe to share
+ *  between threads without a mutex. The head is
+ *  one 64-bit word: a 48-bit Link pointer plus a
+ *  16-bit tag bumped by every successful CAS, so
+ *  a recycled address never matches a stale head
+ *  (ABA). Popped Links are reclaimed through
+ *  HazardPointers.
+ */
+
+#ifndef LOCKFREESTACK_H_
+#define LOCKFREESTACK_H_
+
+#include <atomic>
+#include <cstdint>
+#include "HazardPointers.h"
+#include "require.h"
+
+template<class T> class LockFreeStack {
+  struct Link {
+    T* data;
+    Link* next;
+    Link(T* dat, Link* nxt)
+      : data(dat), next(nxt) {}
+  };
+  typedef std::uint64_t Word;
+  static_assert(sizeof(Link*) == sizeof(Word),
+    "LockFreeStack packs the tag into 64 bits");
+  static const Word ptrMask = (Word(1) << 48) - 1;
+  static const Word tagOne = Word(1) << 48;
+  std::atomic<Word> head;
+  static Link* link(Word w) {
+    return reinterpret_cast<Link*>(w & ptrMask);
+  }
+  // New head word with the tag moved on:
+  static Word tagged(Link* p, Word old) {
+    return reinterpret_cast<Word>(p) |
+      ((old & ~ptrMask) + tagOne);
+  }
+  // Load head and protect its Link with this
+  // thread's hazard pointer:
+  static Word protect(const std::atomic<Word>& h,
+    std::atomic<void*>& hazard) {
+    Word w = h.load();
+    for(;;) {
+      hazard.store(link(w));
+      Word again = h.load();
+      if(again == w) return w;
+      w = again;
+    }
+  }
+  LockFreeStack(const LockFreeStack&);
+  void operator=(const LockFreeStack&);
+public:
+  LockFreeStack() : head(0) {}
+  ~LockFreeStack();
+  void push(T* dat) {
+    Link* n = new Link(dat, 0);
+    // Test first: require() would build its
+    // message string on every push.
+    if(reinterpret_cast<Word>(n) & ~ptrMask)
+      require(false,
+        "LockFreeStack: pointer over 48 bits");
+    Word old = head.load(std::memory_order_relaxed);
+    do
+      n->next = link(old);
+    while(!head.compare_exchange_weak(old,
+      tagged(n, old), std::memory_order_release,
+      std::memory_order_relaxed));
+  }
+  // Another thread may pop and delete the
+  // element right after peek() returns it:
+  T* peek() const {
+    std::atomic<void*>& hp = HazardPointers::hazard();
+    Link* top = link(protect(head, hp));
+    T* result = top ? top->data : 0;
+    hp.store(0);
+    return result;
+  }
+  T* pop();
+  // Iteration reads the Links without hazard
+  // protection: only use it while no thread pops.
+  class iterator;
+  friend class iterator;
+  class iterator {
+    Link* p;
+  public:
+    iterator(const LockFreeStack& tl)
+      : p(link(tl.head.load())) {}
+    iterator(const iterator& tl) : p(tl.p) {}
+    // The end sentinel iterator:
+    iterator() : p(0) {}
+    // operator++ returns boolean indicating end:
+    bool operator++() {
+      if(p->next)
+        p = p->next;
+      else p = 0; // Indicates end of list
+      return bool(p);
+    }
+    bool operator++(int) { return operator++(); }
+    T* current() const {
+      if(!p) return 0;
+      return p->data;
+    }
+    T* operator->() const {
+      require(p != 0,
+        "LockFreeStack::iterator::operator->returns 0");
+      return current();
+    }
+    T* operator*() const { return current(); }
+    // bool conversion for conditional test:
+    operator bool() const { return bool(p); }
+    // Comparison to test for end:
+    bool operator==(const iterator&) const {
+      return p == 0;
+    }
+    bool operator!=(const iterator&) const {
+      return p != 0;
+    }
+  };
+  iterator begin() const {
+    return iterator(*this);
+  }
+  iterator end() const { return iterator(); }
+};
+
+// Not concurrent: the stack is going away.
+template<class T> LockFreeStack<T>::~LockFreeStack() {
+  Link* p = link(head.load());
+  while(p) {
+    Link* next = p->next;
+    delete p->data;
+    delete p;
+    p = next;
+  }
+}
+
+template<class T> T* LockFreeStack<T>::pop() {
+  std::atomic<void*>& hp = HazardPointers::hazard();
+  for(;;) {
+    Word old = protect(head, hp);
+    Link* top = link(old);
+    if(top == 0) {
+      hp.store(0);
+      return 0;
+    }
+    // top can't be freed while hp holds it:
+    if(head.compare_exchange_strong(old,
+      tagged(top->next, old))) {
+      hp.store(0);
+      T* result = top->data;
+      HazardPointers::retire(top);
+      return result;
+    }
+  }
+}
+
+#endif /* LOCKFREESTACK_H_ */
@@ -6,6 +6,7 @@
 #ifndef SELFCOUNTER_H
 #define SELFCOUNTER_H
 #include "ValueStack.h"
+#include "Trace.h"
 #include <iostream>
 
 class SelfCounter {
@@ -13,18 +14,17 @@ class SelfCounter {
   int id;
 public:
   SelfCounter() : id(counter++) {
-    std::cout << "Created: " << id << std::endl;
+    TRACE("Created: " << id);
   }
   SelfCounter(const SelfCounter& rv) : id(rv.id){
-    std::cout << "Copied: " << id << std::endl;
+    TRACE("Copied: " << id);
   }
   SelfCounter operator=(const SelfCounter& rv) {
-    std::cout << "Assigned " << rv.id << " to " 
-              << id << std::endl;
+    TRACE("Assigned " << rv.id << " to " << id);
     return *this;
   }
   ~SelfCounter() {
-    std::cout << "Destroyed: "<< id << std::endl;
+    TRACE("Destroyed: "<< id);
   }
   friend std::ostream& operator<<( 
     std::ostream& os, const SelfCounter& sc){
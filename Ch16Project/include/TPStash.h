@@ -7,26 +7,42 @@
 #define TPSTASH_H
 
 #include<string.h>
+#include <vector>
 
 template<class T, int incr = 10>
 class PStash {
   int quantity; // Number of storage spaces
   int next; // Next empty space
   T** storage;
+  // Indices of removed slots, reused by add():
+  int* holes;
+  int holeCount;
   void inflate(int increase = incr);
 public:
-  PStash() : quantity(0), next(0), storage(0) {}
+  PStash() : quantity(0), next(0), storage(0),
+    holes(0), holeCount(0) {}
   ~PStash();
   int add(T* element);
   T* operator[](int index) const; // Fetch
   // Remove the reference from this PStash:
   T* remove(int index);
-  // Number of elements in Stash:
+  // Number of elements in Stash (the limit for
+  // indexing, removed slots included):
   int count() const { return next; }
+  int live() const { return next - holeCount; }
+  int dead() const { return holeCount; }
+  // Close the holes; remap[old index] is the new
+  // index, or -1 for a removed slot:
+  std::vector<int> compact();
 };
 
 template<class T, int incr>
 int PStash<T, incr>::add(T* element) {
+  if(holeCount > 0) { // Fill a hole first
+    int index = holes[--holeCount];
+    storage[index] = element;
+    return index;
+  }
   if(next >= quantity)
     inflate(incr);
   storage[next++] = element;
@@ -41,6 +57,7 @@ PStash<T, incr>::~PStash() {
     storage[i] = 0; // Just to be safe
   }
   delete []storage;
+  delete []holes;
 }
 
 template<class T, int incr>
@@ -60,18 +77,43 @@ T* PStash<T, incr>::remove(int index) {
   // operator[] performs validity checks:
   T* v = operator[](index);
   // "Remove" the pointer:
-  if(v != 0) storage[index] = 0;
+  if(v != 0) {
+    storage[index] = 0;
+    holes[holeCount++] = index;
+  }
   return v;
 }
 
+template<class T, int incr>
+std::vector<int> PStash<T, incr>::compact() {
+  std::vector<int> remap(next, -1);
+  int live = 0;
+  for(int i = 0; i < next; i++)
+    if(storage[i] != 0) {
+      remap[i] = live;
+      storage[live++] = storage[i];
+    }
+  for(int i = live; i < next; i++)
+    storage[i] = 0;
+  next = live;
+  holeCount = 0;
+  return remap;
+}
+
 template<class T, int incr>
 void PStash<T, incr>::inflate(int increase) {
   const int psz = sizeof(T*);
   T** st = new T*[quantity + increase];
   memset(st, 0, (quantity + increase) * psz);
   memcpy(st, storage, quantity * psz);
+  // At most one hole per slot:
+  int* h = new int[quantity + increase];
+  if(holes)
+    memcpy(h, holes, holeCount * sizeof(int));
   quantity += increase;
   delete []storage; // Old storage
   storage = st; // Point to new memory
+  delete []holes;
+  holes = h;
 }
 #endif // TPSTASH_H ///:~
@@ -0,0 +1,139 @@
+/*
+ * LockFreeStackTest.cpp
+ *
+ *  Multi-producer/multi-consumer stress test of
+ *  LockFreeStack, then push/pop throughput from
+ *  1 to N threads against TStack2's Stack behind
+ *  a mutex.
+ *  Usage: LockFreeStackTest [itemsPerProducer [opsPerThread]]
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "LockFreeStack.h"
+#include "TStack2.h"
+#include "require.h"
+using namespace std;
+
+void stress(int producers, int consumers, int perProducer) {
+  LockFreeStack<int> stack;
+  const int total = producers * perProducer;
+  vector<atomic<char> > seen(total);
+  for(int i = 0; i < total; i++)
+    seen[i].store(0);
+  atomic<int> consumed(0);
+  vector<thread> threads;
+  for(int p = 0; p < producers; p++)
+    threads.push_back(thread([&, p] {
+      for(int i = 0; i < perProducer; i++)
+        stack.push(new int(p * perProducer + i));
+    }));
+  for(int c = 0; c < consumers; c++)
+    threads.push_back(thread([&] {
+      while(consumed.load() < total) {
+        int* v = stack.pop();
+        if(v == 0) {
+          this_thread::yield();
+          continue;
+        }
+        require(seen[*v].fetch_add(1) == 0,
+          "LockFreeStackTest: element popped twice");
+        delete v;
+        consumed++;
+      }
+    }));
+  for(size_t i = 0; i < threads.size(); i++)
+    threads[i].join();
+  for(int i = 0; i < total; i++)
+    require(seen[i].load() == 1,
+      "LockFreeStackTest: element lost");
+  require(stack.pop() == 0,
+    "LockFreeStackTest: stack not empty");
+  cout << producers << " producers, " << consumers
+       << " consumers: " << total
+       << " elements, each popped once" << endl;
+}
+
+int item;
+
+// Every thread does ops push/pop pairs:
+template<class Push, class Pop>
+double mopsPerSec(int nThreads, int ops,
+  Push push, Pop pop) {
+  vector<thread> threads;
+  chrono::steady_clock::time_point start =
+    chrono::steady_clock::now();
+  for(int t = 0; t < nThreads; t++)
+    threads.push_back(thread([&] {
+      for(int i = 0; i < ops; i++) {
+        push(&item);
+        pop();
+      }
+    }));
+  for(int t = 0; t < nThreads; t++)
+    threads[t].join();
+  double secs = chrono::duration<double>(
+    chrono::steady_clock::now() - start).count();
+  return 2.0 * ops * nThreads / secs / 1e6;
+}
+
+int main(int argc, char* argv[]) {
+  int perProducer = 200000, ops = 500000;
+  if(argc > 1) perProducer = atoi(argv[1]);
+  if(argc > 2) ops = atoi(argv[2]);
+  // Same interface as TStack2:
+  LockFreeStack<string> lines;
+  for(int i = 0; i < 5; i++)
+    lines.push(new string(5 - i, '*'));
+  for(LockFreeStack<string>::iterator it =
+    lines.begin(); it != lines.end(); it++)
+    cout << it->c_str() << endl;
+  require(lines.peek()->size() == 1,
+    "LockFreeStackTest: peek");
+  delete lines.pop();
+
+  stress(1, 1, perProducer);
+  stress(4, 4, perProducer);
+  stress(8, 2, perProducer);
+  stress(2, 8, perProducer);
+
+  int maxThreads = thread::hardware_concurrency();
+  if(maxThreads < 1) maxThreads = 1;
+  cout << "threads\tLockFreeStack\tmutex+Stack"
+          "  [M push/pop per s]" << endl;
+  for(int n = 1; n <= maxThreads;
+    n = (n * 2 > maxThreads && n < maxThreads) ?
+      maxThreads : n * 2) {
+    LockFreeStack<int> lf;
+    Stack<int> locked;
+    mutex m;
+    double lfRate = mopsPerSec(n, ops,
+      [&](int* p) { lf.push(p); },
+      [&] { lf.pop(); });
+    double lockedRate = mopsPerSec(n, ops,
+      [&](int* p) {
+        lock_guard<mutex> lock(m);
+        locked.push(p);
+      },
+      [&] {
+        lock_guard<mutex> lock(m);
+        locked.pop();
+      });
+    cout << n << "\t" << lfRate << "\t\t"
+         << lockedRate << endl;
+    // A pop can miss while another thread holds
+    // the only element; don't let the destructors
+    // delete &item:
+    while(lf.pop())
+      ;
+    while(locked.pop())
+      ;
+  }
+  return 0;
+}
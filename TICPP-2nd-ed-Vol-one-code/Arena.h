@@ -0,0 +1,139 @@
+//: :Arena.h
+// Request-scoped allocation. make<T>() places a
+// T with placement new at a bump pointer in a
+// large chunk; a T with a destructor is also
+// recorded (in the arena itself) so reset() can
+// run the destructors, newest first. reset() then
+// rewinds to the first chunk and keeps every
+// chunk for the next round, so without
+// destructors to run it is O(1).
+#ifndef ARENA_H
+#define ARENA_H
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+class Arena {
+  struct Chunk {
+    Chunk* next;
+    std::size_t size; // Usable bytes after this
+    char* begin() { return (char*)(this + 1); }
+  };
+  struct Cleanup {
+    void (*destroy)(void*);
+    void* object;
+    Cleanup* next;
+  };
+  Chunk* first;
+  Chunk* current;
+  char* top;       // Next free byte in current
+  char* end;
+  std::size_t chunkSize;
+  Cleanup* cleanups;
+  static char* align(char* p, std::size_t a) {
+    std::uintptr_t u = std::uintptr_t(p);
+    return (char*)((u + a - 1) & ~(a - 1));
+  }
+  // Move on to a chunk with room for n bytes:
+  void advance(std::size_t n, std::size_t a) {
+    std::size_t need = n + a;
+    Chunk* c = current ? current->next : first;
+    if(c == 0 || c->size < need) {
+      std::size_t size =
+        need > chunkSize ? need : chunkSize;
+      Chunk* fresh = (Chunk*)::operator new(
+        sizeof(Chunk) + size);
+      // A new_handler may have run trim() (see
+      // MemoryPressure.h) and freed c, so find
+      // the spare chunks again:
+      Chunk*& spare = current ? current->next : first;
+      fresh->size = size;
+      fresh->next = spare;
+      spare = fresh;
+      c = fresh;
+    }
+    current = c;
+    top = c->begin();
+    end = top + c->size;
+  }
+  template<class T>
+  static void destroy(void* p) {
+    static_cast<T*>(p)->~T();
+  }
+  Arena(const Arena&);
+  void operator=(const Arena&);
+public:
+  Arena(std::size_t bytesPerChunk = 64 * 1024)
+    : first(0), current(0), top(0), end(0),
+    chunkSize(bytesPerChunk), cleanups(0) {}
+  ~Arena() {
+    reset();
+    while(first) {
+      Chunk* next = first->next;
+      ::operator delete(first);
+      first = next;
+    }
+  }
+  void* allocate(std::size_t n,
+    std::size_t a = alignof(std::max_align_t)) {
+    char* p = align(top, a);
+    if(top == 0 || p + n > end) {
+      advance(n, a);
+      p = align(top, a);
+    }
+    top = p + n;
+    return p;
+  }
+  template<class T, class... Args>
+  T* make(Args&&... args) {
+    // ::new, so that no operator new of T's own
+    // is found for the placement form:
+    T* t = ::new(static_cast<void*>(
+      allocate(sizeof(T), alignof(T))))
+      T(std::forward<Args>(args)...);
+    if(!std::is_trivially_destructible<T>::value) {
+      Cleanup* c = ::new(static_cast<void*>(
+        allocate(sizeof(Cleanup), alignof(Cleanup))))
+        Cleanup;
+      c->destroy = &destroy<T>;
+      c->object = t;
+      c->next = cleanups;
+      cleanups = c;
+    }
+    return t;
+  }
+  // Destroy everything made since the last reset
+  // and start over; the chunks stay allocated:
+  void reset() {
+    while(cleanups) {
+      Cleanup* c = cleanups;
+      cleanups = c->next;
+      c->destroy(c->object);
+    }
+    current = 0;
+    top = end = 0;
+  }
+  // Free the chunks past the one in use (all of
+  // them after a reset()); returns the bytes
+  // released:
+  std::size_t trim() {
+    std::size_t released = 0;
+    Chunk*& spare = current ? current->next : first;
+    while(spare) {
+      Chunk* next = spare->next;
+      released += sizeof(Chunk) + spare->size;
+      ::operator delete(spare);
+      spare = next;
+    }
+    return released;
+  }
+  int chunks() const {
+    int n = 0;
+    for(Chunk* c = first; c; c = c->next)
+      n++;
+    return n;
+  }
+};
+#endif // ARENA_H ///:~
@@ -3,18 +3,23 @@
 // Available at http://www.BruceEckel.com
 // (c) Bruce Eckel 2000
 // Copyright notice in Copyright.txt
-// Break a file into whitespace-separated words
-#include <string>
+// Break a file into whitespace-separated words.
+// The file is mapped into memory and each word
+// is a string_view into the mapping, so no
+// string is allocated per word (see Words.h).
+#include "../MappedFile.h"
+#include "../Words.h"
+#include <string_view>
 #include <iostream>
-#include <fstream>
 #include <vector>
 using namespace std;
 
 int main() {
-  vector<string> words;
-  ifstream in("GetWords.cpp");
-  string word;
-  while(in >> word)
+  vector<string_view> words;
+  MappedFile in("GetWords.cpp");
+  Words text(in.data(), in.size());
+  string_view word;
+  while(text >> word)
     words.push_back(word); 
   for(int i = 0; i < words.size(); i++)
     cout << words[i] << endl;
@@ -0,0 +1,112 @@
+//: C02:KeywordsTiming.cpp
+// Counting 1, 10, 100 and 1000 keywords at once:
+// comparing every word with every keyword, as
+// WordCountInFile's strcmp() loop would; a
+// WordCount of all the words, then a lookup per
+// keyword; and one Keywords pass, for whole
+// words and for every occurrence. The strcmp()
+// loop only reads a share of the text that
+// shrinks as the keywords grow.
+// Usage: KeywordsTiming [megabytes [file]]
+#include "../MappedFile.h"
+#include "../Keywords.h"
+#include "../Words.h"
+#include "../Stopwatch.h"
+#include "../require.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+void writeText(const char* name, long bytes) {
+  ofstream out(name);
+  assure(out, name);
+  srand(47);
+  long written = 0;
+  char word[16];
+  while(written < bytes) {
+    int r = rand() % 100;
+    int id = r < 50 ? r % 20 : rand() % 100000;
+    int len = sprintf(word, "w%d", id);
+    out << word << (rand() % 12 == 0 ? '\n' : ' ');
+    written += len + 1;
+  }
+}
+
+double gbs(double bytes, double secs) {
+  return bytes / secs / 1e9;
+}
+
+int main(int argc, char* argv[]) {
+  long megabytes = 128;
+  const char* name = "KeywordsTiming.txt";
+  if(argc > 1) megabytes = atol(argv[1]);
+  if(argc > 2) name = argv[2];
+  else {
+    require(megabytes > 0,
+      "KeywordsTiming: bad size");
+    writeText(name, megabytes << 20);
+  }
+  MappedFile file(name);
+  require(!file.fail(), name);
+  const char* text = file.data();
+  size_t n = file.size();
+  cout << name << ": " << n / 1e6 << " MB, GB/s:"
+       << endl << "keywords\tstrcmp\tWordCount"
+       << "\tKeywords\tsubstrings\tstates" << endl;
+  Stopwatch sw;
+  WordCount all(text, n);
+  double counted = sw.seconds();
+  for(int k = 1; k <= 1000; k *= 10) {
+    // Common and rare words, and some absent:
+    vector<string> kw;
+    char word[16];
+    for(int i = 0; i < k; i++) {
+      sprintf(word, "w%d", i * 997 % 200000);
+      kw.push_back(word);
+    }
+    // strcmp() over the first 1/k of the text:
+    size_t part = n / k;
+    while(part < n && text[part] != ' '
+      && text[part] != '\n') part++;
+    sw.mark();
+    vector<long> slow(k, 0);
+    Words in(text, part);
+    string_view w;
+    string token;
+    while(in >> w) {
+      token.assign(w.data(), w.size());
+      for(int i = 0; i < k; i++)
+        if(!strcmp(token.c_str(), kw[i].c_str()))
+          slow[i]++;
+    }
+    double slowGbs = gbs(part, sw.seconds());
+    sw.mark();
+    vector<long> hashed(k);
+    for(int i = 0; i < k; i++)
+      hashed[i] = all[kw[i]];
+    double lookup = sw.seconds();
+    sw.mark();
+    Keywords words(kw);
+    vector<long> found = words.count(text, n);
+    double ac = sw.seconds();
+    require(found == hashed,
+      "KeywordsTiming: Keywords disagrees");
+    Keywords inside(kw, false);
+    sw.mark();
+    vector<long> sub = inside.count(text, n);
+    double subSecs = sw.seconds();
+    for(int i = 0; i < k; i++)
+      require(sub[i] >= found[i],
+        "KeywordsTiming: substrings missed");
+    cout << k << "\t\t" << slowGbs << "\t"
+         << gbs(n, counted + lookup) << "\t\t"
+         << gbs(n, ac) << "\t\t"
+         << gbs(n, subSecs) << "\t\t"
+         << words.states() << endl;
+  }
+} ///:~
@@ -0,0 +1,121 @@
+//: C02:WordCountTiming.cpp
+// Word frequencies three ways: `in >> word` into
+// an unordered_map<string, long>, then WordCount
+// on 1, 2, 4 ... threads up to the number of
+// cores, then WordCount::occurrences() against
+// WordCountInFile's strcmp() loop for a single
+// word. Without a file argument, writes a text
+// file of the given size first.
+// Usage: WordCountTiming [megabytes [file [word]]]
+#include "../MappedFile.h"
+#include "../WordCount.h"
+#include "../Stopwatch.h"
+#include "../require.h"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+using namespace std;
+
+void writeText(const char* name, long bytes) {
+  ofstream out(name);
+  assure(out, name);
+  srand(47);
+  long written = 0;
+  char word[16];
+  while(written < bytes) {
+    // A few common words and a long tail:
+    int r = rand() % 100;
+    int id = r < 50 ? r % 20 : rand() % 100000;
+    int len = sprintf(word, "w%d", id);
+    if(id == 7) len = sprintf(word, "radius");
+    out << word << (rand() % 12 == 0 ? '\n' : ' ');
+    written += len + 1;
+  }
+}
+
+double gbs(double bytes, double secs) {
+  return bytes / secs / 1e9;
+}
+
+int main(int argc, char* argv[]) {
+  long megabytes = 256;
+  const char* name = "WordCountTiming.txt";
+  const char* target = "radius";
+  if(argc > 1) megabytes = atol(argv[1]);
+  if(argc > 2) name = argv[2];
+  else {
+    require(megabytes > 0,
+      "WordCountTiming: bad size");
+    writeText(name, megabytes << 20);
+  }
+  if(argc > 3) target = argv[3];
+  MappedFile file(name);
+  require(!file.fail(), name);
+  double bytes = file.size();
+  int cores = WordCount::defaultThreads();
+  cout << name << ": " << bytes / 1e6 << " MB, "
+       << cores << " cores" << endl;
+
+  Stopwatch sw;
+  unordered_map<string, long> map;
+  long words = 0;
+  {
+    ifstream in(name);
+    string w;
+    while(in >> w) {
+      map[w]++;
+      words++;
+    }
+  }
+  cout << "unordered_map\t\t"
+       << gbs(bytes, sw.seconds()) << " GB/s" << endl;
+  for(int t = 1; ; t = min(t * 2, cores)) {
+    sw.mark();
+    WordCount wc(file.data(), file.size(), t);
+    double secs = sw.seconds();
+    require(wc.total() == words &&
+      wc.distinct() == map.size() &&
+      wc[target] == map[target],
+      "WordCountTiming: counts disagree");
+    cout << "WordCount, " << t << " thread"
+         << (t > 1 ? "s\t" : "\t") << gbs(bytes, secs)
+         << " GB/s" << endl;
+    if(t == cores) {
+      cout << words << " words, " << wc.distinct()
+           << " distinct; top 5:";
+      vector<WordCount::Freq> top = wc.top(5);
+      for(size_t i = 0; i < top.size(); i++)
+        cout << " " << top[i].first << " "
+             << top[i].second;
+      cout << endl;
+      break;
+    }
+  }
+
+  sw.mark();
+  long found = 0;
+  {
+    ifstream in(name);
+    string w;
+    while(in >> w)
+      if(!strcmp(w.c_str(), target)) found++;
+  }
+  cout << "strcmp \"" << target << "\"\t\t"
+       << gbs(bytes, sw.seconds()) << " GB/s" << endl;
+  for(int t = 1; ; t = min(t * 2, cores)) {
+    sw.mark();
+    long n = WordCount::occurrences(file.data(),
+      file.size(), target, t);
+    double secs = sw.seconds();
+    require(n == found,
+      "WordCountTiming: occurrences disagree");
+    cout << "occurrences, " << t << " thread"
+         << (t > 1 ? "s\t" : "\t") << gbs(bytes, secs)
+         << " GB/s" << endl;
+    if(t == cores) break;
+  }
+  cout << found << " \"" << target << "\"" << endl;
+} ///:~
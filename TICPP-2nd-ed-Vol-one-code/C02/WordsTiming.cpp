@@ -0,0 +1,107 @@
+//: C02:WordsTiming.cpp
+// GetWords.cpp's `in >> word` loop against the
+// Words tokenizer over a MappedFile, with each
+// instruction set Words can use. Without a file
+// argument, writes a text file of the given
+// size first; pass a multi-gigabyte file to see
+// the rate once it no longer fits in the cache.
+// Usage: WordsTiming [megabytes [file]]
+#include "../MappedFile.h"
+#include "../Words.h"
+#include "../Stopwatch.h"
+#include "../require.h"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+using namespace std;
+
+void writeText(const char* name, long bytes) {
+  const char* vocabulary[] = { "the", "radius",
+    "of", "a", "circle", "is", "half", "its",
+    "diameter", "std::vector<std::string>", "{",
+    "}", "=", "3.14159", "area", "\t" };
+  ofstream out(name);
+  assure(out, name);
+  srand(47);
+  long written = 0;
+  while(written < bytes) {
+    const char* w = vocabulary[rand() % 16];
+    out << w << (rand() % 10 == 0 ? '\n' : ' ');
+    written += strlen(w) + 1;
+  }
+}
+
+struct Result {
+  long words, letters;
+  double seconds;
+};
+
+void report(const char* label, Result r,
+  double bytes) {
+  cout << label << "\t" << r.words << " words\t"
+       << bytes / r.seconds / 1e9 << " GB/s"
+       << endl;
+}
+
+// The old loop. The words aren't kept in a
+// vector<string> here, or a file bigger than
+// RAM couldn't be timed:
+Result stream(const char* name) {
+  Stopwatch sw;
+  ifstream in(name);
+  assure(in, name);
+  string word;
+  Result r = { 0, 0, 0 };
+  while(in >> word) {
+    r.words++;
+    r.letters += word.size();
+  }
+  r.seconds = sw.seconds();
+  return r;
+}
+
+Result views(const char* name, Words::Isa isa) {
+  Stopwatch sw;
+  MappedFile in(name);
+  require(!in.fail(), name);
+  Words text(in.data(), in.size(), isa);
+  string_view word;
+  Result r = { 0, 0, 0 };
+  while(text >> word) {
+    r.words++;
+    r.letters += word.size();
+  }
+  r.seconds = sw.seconds();
+  return r;
+}
+
+int main(int argc, char* argv[]) {
+  long megabytes = 256;
+  const char* name = "WordsTiming.txt";
+  if(argc > 1) megabytes = atol(argv[1]);
+  if(argc > 2) name = argv[2];
+  else {
+    require(megabytes > 0,
+      "WordsTiming: bad size");
+    writeText(name, megabytes << 20);
+  }
+  MappedFile file(name);
+  require(!file.fail(), name);
+  double bytes = file.size();
+  cout << name << ": " << bytes / 1e6 << " MB, "
+       << "CPU has " << Words::name(Words::detect())
+       << endl;
+  Result old = stream(name);
+  report("in >> string", old, bytes);
+  for(int isa = Words::scalar;
+    isa <= Words::detect(); isa++) {
+    Result r = views(name, Words::Isa(isa));
+    require(r.words == old.words &&
+      r.letters == old.letters,
+      "WordsTiming: Words disagrees with >>");
+    report(Words::name(Words::Isa(isa)), r, bytes);
+  }
+} ///:~
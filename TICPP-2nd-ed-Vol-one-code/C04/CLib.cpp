@@ -6,11 +6,12 @@
 // Implementation of example C-like library
 // Declare structure and functions:
 #include "CLib.h"
+#include "../CopyBytes.h"
 #include <iostream>
 #include <cassert> 
 using namespace std;
 // Quantity of elements to add
-// when increasing storage:
+// when increasing storage (default policy):
 const int increment = 100;
 
 void initialize(CStash* s, int sz) {
@@ -18,21 +19,38 @@ void initialize(CStash* s, int sz) {
   s->quantity = 0;
   s->storage = 0;
   s->next = 0;
+  s->growth = fixedGrowth(increment);
+}
+
+void setGrowth(CStash* s, Growth growth) {
+  s->growth = growth;
 }
 
 int add(CStash* s, const void* element) {
   if(s->next >= s->quantity) //Enough space left?
-    inflate(s, increment);
+    inflate(s, s->growth.grow(s->quantity,
+      s->next + 1, s->size) - s->quantity);
   // Copy element into storage,
   // starting at next empty space:
   int startBytes = s->next * s->size;
-  unsigned char* e = (unsigned char*)element;
-  for(int i = 0; i < s->size; i++)
-    s->storage[startBytes + i] = e[i];
+  copyBytes(&s->storage[startBytes], element, s->size);
   s->next++;
   return(s->next - 1); // Index number
 }
 
+// Append n contiguous elements in one copy:
+int addN(CStash* s, const void* elements, int n) {
+  assert(n >= 0);
+  if(s->next + n > s->quantity)
+    inflate(s, s->growth.grow(s->quantity,
+      s->next + n, s->size) - s->quantity);
+  int first = s->next;
+  copyBytes(&s->storage[first * s->size], elements,
+    n * s->size);
+  s->next += n;
+  return first; // Index of the first element
+}
+
 void* fetch(CStash* s, int index) {
   // Check index boundaries:
   assert(0 <= index);
@@ -52,13 +70,32 @@ void inflate(CStash* s, int increase) {
   int newBytes = newQuantity * s->size;
   int oldBytes = s->quantity * s->size;
   unsigned char* b = new unsigned char[newBytes];
-  for(int i = 0; i < oldBytes; i++)
-    b[i] = s->storage[i]; // Copy old to new
+  copyBytes(b, s->storage, oldBytes); // Old to new
   delete [](s->storage); // Old storage
   s->storage = b; // Point to new memory
   s->quantity = newQuantity;
 }
 
+// Make room for at least quantity elements:
+void reserve(CStash* s, int quantity) {
+  if(quantity > s->quantity)
+    inflate(s, quantity - s->quantity);
+}
+
+// Release the unused tail of storage:
+void shrinkToFit(CStash* s) {
+  if(s->next == s->quantity) return;
+  unsigned char* b = 0;
+  int bytes = s->next * s->size;
+  if(bytes > 0) {
+    b = new unsigned char[bytes];
+    copyBytes(b, s->storage, bytes);
+  }
+  delete [](s->storage);
+  s->storage = b;
+  s->quantity = s->next;
+}
+
 void cleanup(CStash* s) {
   if(s->storage != 0) {
    cout << "freeing storage" << endl;
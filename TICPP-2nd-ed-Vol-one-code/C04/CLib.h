@@ -5,6 +5,7 @@
 // Copyright notice in Copyright.txt
 // Header file for a C-like library
 // An array-like entity created at runtime
+#include "../Growth.h"
 
 typedef struct CStashTag {
   int size;      // Size of each space
@@ -12,12 +13,17 @@ typedef struct CStashTag {
   int next;      // Next empty space
   // Dynamically allocated array of bytes:
   unsigned char* storage;
+  Growth growth; // How inflate() sizes storage
 } CStash;
 
 void initialize(CStash* s, int size);
 void cleanup(CStash* s);
 int add(CStash* s, const void* element);
+int addN(CStash* s, const void* elements, int n);
 void* fetch(CStash* s, int index);
 int count(CStash* s);
 void inflate(CStash* s, int increase);
+void setGrowth(CStash* s, Growth growth);
+void reserve(CStash* s, int quantity);
+void shrinkToFit(CStash* s);
 ///:~
@@ -6,6 +6,7 @@
 // C library converted to C++
 // Declare structure and functions:
 #include "CppLib.h"
+#include "../CopyBytes.h"
 #include <iostream>
 #include <cassert>
 using namespace std;
@@ -26,13 +27,26 @@ int Stash::add(const void* element) {
   // Copy element into storage,
   // starting at next empty space:
   int startBytes = next * size;
-  unsigned char* e = (unsigned char*)element;
-  for(int i = 0; i < size; i++)
-    storage[startBytes + i] = e[i];
+  copyBytes(&storage[startBytes], element, size);
   next++;
   return(next - 1); // Index number
 }
 
+// Append n contiguous elements in one copy:
+int Stash::addN(const void* elements, int n) {
+  assert(n >= 0);
+  if(next + n > quantity) {
+    int increase = next + n - quantity;
+    inflate(increase > increment ?
+      increase : increment);
+  }
+  int first = next;
+  copyBytes(&storage[first * size], elements,
+    n * size);
+  next += n;
+  return first; // Index of the first element
+}
+
 void* Stash::fetch(int index) {
   // Check index boundaries:
   assert(0 <= index);
@@ -52,8 +66,7 @@ void Stash::inflate(int increase) {
   int newBytes = newQuantity * size;
   int oldBytes = quantity * size;
   unsigned char* b = new unsigned char[newBytes];
-  for(int i = 0; i < oldBytes; i++)
-    b[i] = storage[i]; // Copy old to new
+  copyBytes(b, storage, oldBytes); // Old to new
   delete []storage; // Old storage
   storage = b; // Point to new memory
   quantity = newQuantity;
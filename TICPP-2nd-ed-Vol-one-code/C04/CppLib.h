@@ -15,6 +15,7 @@ struct Stash {
   void initialize(int size);
   void cleanup();
   int add(const void* element);
+  int addN(const void* elements, int n);
   void* fetch(int index);
   int count();
   void inflate(int increase);
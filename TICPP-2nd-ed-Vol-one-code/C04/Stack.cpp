@@ -17,7 +17,7 @@ Stack::Link::initialize(void* dat, Link* nxt) {
 void Stack::initialize() { head = 0; }
 
 void Stack::push(void* dat) {
-  Link* newLink = new Link;
+  Link* newLink = (Link*)pool.allocate();
   newLink->initialize(dat, head);
   head = newLink;
 }
@@ -32,7 +32,7 @@ void* Stack::pop() {
   void* result = head->data;
   Link* oldHead = head;
   head = head->next;
-  delete oldHead;
+  pool.deallocate(oldHead);
   return result;
 }
 
@@ -6,6 +6,7 @@
 // Nested struct in linked list
 #ifndef STACK_H
 #define STACK_H
+#include "../NodePool.h"
 
 struct Stack {
   struct Link {
@@ -13,6 +14,7 @@ struct Stack {
     Link* next;
     void initialize(void* dat, Link* nxt);
   }* head;
+  NodePool<Link> pool; // This stack's Links
   void initialize();
   void push(void* dat);
   void* peek();
@@ -0,0 +1,138 @@
+//: C06:MappedStash.cpp {O}
+// File-backed Stash: grows with ftruncate()
+// and mremap() (Linux)
+#include "MappedStash.h"
+#include "../require.h"
+#include "../CopyBytes.h"
+#include <cassert>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+using namespace std;
+
+static const char magic[8] = "MSTASH1";
+
+MappedStash::MappedStash(const string& fname,
+  int sz, Growth g) : fd(-1), mapped(0), header(0),
+  storage(0), growth(g), fileName(fname) {
+  require(sz > 0, "MappedStash: bad element size");
+  fd = open(fileName.c_str(), O_RDWR | O_CREAT, 0644);
+  require(fd >= 0,
+    "MappedStash: cannot open " + fileName);
+  struct stat st;
+  require(fstat(fd, &st) == 0, "MappedStash: fstat");
+  // Only an empty file is new; anything else
+  // must hold a whole header:
+  bool fresh = st.st_size == 0;
+  require(fresh || size_t(st.st_size) >= headerBytes,
+    fileName + " is not a MappedStash");
+  if(fresh) {
+    require(ftruncate(fd, headerBytes) == 0,
+      "MappedStash: ftruncate");
+    mapped = headerBytes;
+  } else
+    mapped = st.st_size;
+  void* m = mmap(0, mapped, PROT_READ | PROT_WRITE,
+    MAP_SHARED, fd, 0);
+  require(m != MAP_FAILED, "MappedStash: mmap");
+  header = (Header*)m;
+  storage = (unsigned char*)m + headerBytes;
+  if(fresh) {
+    memcpy(header->magic, magic, sizeof magic);
+    header->size = sz;
+    header->quantity = 0;
+    header->next = 0;
+  } else {
+    require(memcmp(header->magic, magic,
+      sizeof magic) == 0,
+      fileName + " is not a MappedStash");
+    require(header->size == sz,
+      fileName + " has a different element size");
+    require(header->quantity >= 0 &&
+      header->next >= 0 &&
+      header->next <= header->quantity,
+      fileName + " has a corrupt header");
+    require(mapped >= headerBytes +
+      size_t(header->quantity) * sz,
+      fileName + " is truncated");
+  }
+}
+
+MappedStash::~MappedStash() {
+  munmap(header, mapped);
+  close(fd);
+}
+
+int MappedStash::add(const void* element) {
+  return addN(element, 1);
+}
+
+// Append n contiguous elements in one copy:
+int MappedStash::addN(const void* elements, int n) {
+  assert(n >= 0);
+  require(n <= INT_MAX - header->next,
+    "MappedStash::addN: too many elements");
+  // Only the element count must fit in an int;
+  // the file may be larger than RAM:
+  if(header->next + n > header->quantity)
+    inflate(int(growth.grow(long(header->quantity),
+      long(header->next) + n, header->size,
+      INT_MAX)) - header->quantity);
+  int first = header->next;
+  size_t bytes = size_t(n) * header->size;
+  unsigned char* dest =
+    &storage[size_t(first) * header->size];
+  if(bytes <= INT_MAX)
+    copyBytes(dest, elements, int(bytes));
+  else
+    memcpy(dest, elements, bytes);
+  header->next += n;
+  return first; // Index of the first element
+}
+
+void* MappedStash::fetch(int index) {
+  require(0 <= index, "MappedStash::fetch (-)index");
+  if(index >= header->next)
+    return 0; // To indicate the end
+  return &storage[size_t(index) * header->size];
+}
+
+void MappedStash::reserve(int n) {
+  if(n > header->quantity)
+    inflate(n - header->quantity);
+}
+
+void MappedStash::shrinkToFit() {
+  if(header->next < header->quantity)
+    resize(header->next);
+}
+
+void MappedStash::sync() {
+  require(msync(header, mapped, MS_SYNC) == 0,
+    "MappedStash: msync");
+}
+
+void MappedStash::inflate(int increase) {
+  require(increase > 0,
+    "MappedStash::inflate zero or negative increase");
+  resize(header->quantity + increase);
+}
+
+// Set the file size and remap it; the mapping
+// may move, so header and storage are reset:
+void MappedStash::resize(int newQuantity) {
+  size_t bytes = headerBytes +
+    size_t(newQuantity) * header->size;
+  require(ftruncate(fd, bytes) == 0,
+    "MappedStash: cannot resize " + fileName);
+  void* m = mremap(header, mapped, bytes,
+    MREMAP_MAYMOVE);
+  require(m != MAP_FAILED, "MappedStash: mremap");
+  mapped = bytes;
+  header = (Header*)m;
+  storage = (unsigned char*)m + headerBytes;
+  header->quantity = newQuantity;
+} ///:~
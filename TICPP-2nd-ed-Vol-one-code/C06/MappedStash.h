@@ -0,0 +1,46 @@
+//: C06:MappedStash.h
+// Stash whose storage is an mmap'ed file. A
+// small header records the element size, count
+// and capacity, so reopening the file gives the
+// stash back with no parsing or copying.
+#ifndef MAPPEDSTASH_H
+#define MAPPEDSTASH_H
+#include "../Growth.h"
+#include <cstddef>
+#include <string>
+
+class MappedStash {
+  struct Header {
+    char magic[8];  // "MSTASH1"
+    int size;       // Size of each space
+    int quantity;   // Number of storage spaces
+    int next;       // Next empty space
+  };
+  // Elements start here; keeps them aligned:
+  enum { headerBytes = 64 };
+  int fd;
+  std::size_t mapped; // Bytes currently mapped
+  Header* header;     // Start of the mapping
+  unsigned char* storage;
+  Growth growth;      // How inflate() sizes the file
+  std::string fileName;
+  void inflate(int increase);
+  void resize(int newQuantity);
+  MappedStash(const MappedStash&);
+  void operator=(const MappedStash&);
+public:
+  // Reopens fileName if it holds a stash of the
+  // same element size, otherwise creates it:
+  MappedStash(const std::string& fileName,
+    int size, Growth g = pagedGrowth());
+  ~MappedStash();
+  int add(const void* element);
+  int addN(const void* elements, int n);
+  void* fetch(int index);
+  int count() const { return header->next; }
+  int capacity() const { return header->quantity; }
+  void reserve(int quantity);
+  void shrinkToFit();
+  void sync(); // Flush to the file now
+};
+#endif // MAPPEDSTASH_H ///:~
@@ -0,0 +1,67 @@
+//: C06:MappedStashTest.cpp
+//{L} MappedStash
+// Stash2Test's int and string stashes, kept in
+// files: the second pass reopens them and finds
+// the data already there.
+#include "MappedStash.h"
+#include "../require.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+using namespace std;
+
+const int bufsize = 80;
+const char* intFile = "MappedStashTest.ints";
+const char* lineFile = "MappedStashTest.lines";
+
+void build() {
+  MappedStash intStash(intFile, sizeof(int));
+  for(int i = 0; i < 100; i++)
+    intStash.add(&i);
+  MappedStash stringStash(lineFile,
+    sizeof(char) * bufsize);
+  ifstream in("MappedStashTest.cpp");
+  assure(in, "MappedStashTest.cpp");
+  string line;
+  char buf[bufsize];
+  while(getline(in, line)) {
+    strncpy(buf, line.c_str(), bufsize - 1);
+    buf[bufsize - 1] = 0;
+    stringStash.add(buf);
+  }
+  stringStash.shrinkToFit();
+} // Both files are unmapped and closed here
+
+int main() {
+  remove(intFile);
+  remove(lineFile);
+  build();
+  // No parsing: the files are just mapped again
+  MappedStash intStash(intFile, sizeof(int));
+  require(intStash.count() == 100,
+    "MappedStashTest: int count not persisted");
+  for(int j = 0; j < intStash.count(); j++)
+    cout << "intStash.fetch(" << j << ") = "
+         << *(int*)intStash.fetch(j)
+         << endl;
+  MappedStash stringStash(lineFile,
+    sizeof(char) * bufsize);
+  require(stringStash.capacity() ==
+    stringStash.count(),
+    "MappedStashTest: shrinkToFit not persisted");
+  int k = 0;
+  char* cp;
+  while((cp = (char*)stringStash.fetch(k++))!=0)
+    cout << "stringStash.fetch(" << k << ") = "
+         << cp << endl;
+  // Appending after a reopen keeps growing:
+  for(int i = 100; i < 10000; i++)
+    intStash.add(&i);
+  for(int i = 0; i < intStash.count(); i++)
+    require(*(int*)intStash.fetch(i) == i,
+      "MappedStashTest: bad element after growth");
+  remove(intFile);
+  remove(lineFile);
+} ///:~
@@ -0,0 +1,78 @@
+//: C06:MappedStashTiming.cpp
+//{L} Stash2 MappedStash
+// Cold start of an int record store: parsing
+// the text source into a Stash on every start
+// versus reopening a MappedStash built once.
+// Usage: MappedStashTiming [elements]
+#include "Stash2.h"
+#include "MappedStash.h"
+#include "../Stopwatch.h"
+#include "../require.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+using namespace std;
+
+const char* textFile = "MappedStashTiming.txt";
+const char* mapFile = "MappedStashTiming.dat";
+
+// The elements are contiguous in the mapping:
+long sum(MappedStash& s) {
+  long total = 0;
+  int* p = (int*)s.fetch(0);
+  for(int i = 0; i < s.count(); i++)
+    total += p[i];
+  return total;
+}
+
+int main(int argc, char* argv[]) {
+  int n = 10000000;
+  if(argc > 1) n = atoi(argv[1]);
+  require(n > 0, "MappedStashTiming: bad count");
+  {
+    ofstream out(textFile);
+    assure(out, textFile);
+    for(int i = 0; i < n; i++)
+      out << i << '\n';
+  }
+  long expected = long(n) * (n - 1) / 2;
+  remove(mapFile);
+  Stopwatch sw;
+  { // One-time conversion to the mapped form
+    MappedStash ms(mapFile, sizeof(int));
+    ifstream in(textFile);
+    int i;
+    while(in >> i)
+      ms.add(&i);
+    ms.shrinkToFit();
+  }
+  cout << "build mapped file:\t" << sw.seconds()
+       << " s" << endl;
+  sw.mark();
+  {
+    Stash intStash(sizeof(int), geometricGrowth());
+    ifstream in(textFile);
+    int i;
+    long total = 0;
+    while(in >> i) {
+      intStash.add(&i);
+      total += i;
+    }
+    require(total == expected, "bad text total");
+    cout << "parse text:\t\t" << sw.seconds()
+         << " s" << endl;
+  }
+  sw.mark();
+  {
+    MappedStash ms(mapFile, sizeof(int));
+    require(ms.count() == n, "bad mapped count");
+    cout << "reopen mapped:\t\t" << sw.seconds()
+         << " s" << endl;
+    require(sum(ms) == expected, "bad mapped total");
+    cout << "reopen + scan mapped:\t" << sw.seconds()
+         << " s" << endl;
+  }
+  remove(textFile);
+  remove(mapFile);
+} ///:~
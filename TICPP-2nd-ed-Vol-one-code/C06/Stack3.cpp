@@ -18,7 +18,7 @@ Stack::Link::~Link() { }
 Stack::Stack() { head = 0; }
 
 void Stack::push(void* dat) {
-  head = new Link(dat,head);
+  head = pool.create(dat, head);
 }
 
 void* Stack::peek() { 
@@ -31,7 +31,7 @@ void* Stack::pop() {
   void* result = head->data;
   Link* oldHead = head;
   head = head->next;
-  delete oldHead;
+  pool.destroy(oldHead);
   return result;
 }
 
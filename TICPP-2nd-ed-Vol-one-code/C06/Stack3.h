@@ -6,6 +6,7 @@
 // With constructors/destructors
 #ifndef STACK3_H
 #define STACK3_H
+#include "../NodePool.h"
 
 class Stack {
   struct Link {
@@ -14,6 +15,7 @@ class Stack {
     Link(void* dat, Link* nxt);
     ~Link();
   }* head;
+  NodePool<Link> pool; // This stack's Links
 public:
   Stack();
   ~Stack();
@@ -5,32 +5,45 @@
 // Copyright notice in Copyright.txt
 // Constructors & destructors
 #include "Stash2.h"
+#include "../CopyBytes.h"
 #include "../require.h"
 #include <iostream>
 #include <cassert>
 using namespace std;
-const int increment = 100;
 
-Stash::Stash(int sz) {
+Stash::Stash(int sz, Growth g) {
   size = sz;
   quantity = 0;
   storage = 0;
   next = 0;
+  growth = g;
 }
 
 int Stash::add(void* element) {
   if(next >= quantity) // Enough space left?
-    inflate(increment);
+    inflate(growth.grow(quantity, next + 1, size)
+      - quantity);
   // Copy element into storage,
   // starting at next empty space:
   int startBytes = next * size;
-  unsigned char* e = (unsigned char*)element;
-  for(int i = 0; i < size; i++)
-    storage[startBytes + i] = e[i];
+  copyBytes(&storage[startBytes], element, size);
   next++;
   return(next - 1); // Index number
 }
 
+// Append n contiguous elements in one copy:
+int Stash::addN(const void* elements, int n) {
+  assert(n >= 0);
+  if(next + n > quantity)
+    inflate(growth.grow(quantity, next + n, size)
+      - quantity);
+  int first = next;
+  copyBytes(&storage[first * size], elements,
+    n * size);
+  next += n;
+  return first; // Index of the first element
+}
+
 void* Stash::fetch(int index) {
   require(0 <= index, "Stash::fetch (-)index");
   if(index >= next)
@@ -50,13 +63,30 @@ void Stash::inflate(int increase) {
   int newBytes = newQuantity * size;
   int oldBytes = quantity * size;
   unsigned char* b = new unsigned char[newBytes];
-  for(int i = 0; i < oldBytes; i++)
-    b[i] = storage[i]; // Copy old to new
+  copyBytes(b, storage, oldBytes); // Old to new
   delete [](storage); // Old storage
   storage = b; // Point to new memory
   quantity = newQuantity;
 }
 
+void Stash::reserve(int n) {
+  if(n > quantity)
+    inflate(n - quantity);
+}
+
+void Stash::shrinkToFit() {
+  if(next == quantity) return;
+  unsigned char* b = 0;
+  int bytes = next * size;
+  if(bytes > 0) {
+    b = new unsigned char[bytes];
+    copyBytes(b, storage, bytes);
+  }
+  delete [](storage);
+  storage = b;
+  quantity = next;
+}
+
 Stash::~Stash() {
   if(storage != 0) {
    cout << "freeing storage" << endl;
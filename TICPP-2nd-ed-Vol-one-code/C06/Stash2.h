@@ -6,6 +6,7 @@
 // With constructors & destructors
 #ifndef STASH2_H
 #define STASH2_H
+#include "../Growth.h"
 
 class Stash {
   int size;      // Size of each space
@@ -13,12 +14,17 @@ class Stash {
   int next;      // Next empty space
   // Dynamically allocated array of bytes:
   unsigned char* storage;
+  Growth growth; // How inflate() sizes storage
   void inflate(int increase);
 public:
-  Stash(int size);
+  Stash(int size, Growth growth = fixedGrowth());
   ~Stash();
   int add(void* element);
+  int addN(const void* elements, int n);
   void* fetch(int index);
   int count();
+  int capacity() const { return quantity; }
+  void reserve(int quantity);
+  void shrinkToFit();
 };
 #endif // STASH2_H ///:~
@@ -0,0 +1,53 @@
+//: C06:StringStash.cpp {O}
+// Arena-backed string stash
+#include "StringStash.h"
+#include <cassert>
+#include <climits>
+#include <cstring>
+using namespace std;
+
+void StringStash::inflate(long minBytes) {
+  long newHeld = growth.grow(held, minBytes, 1,
+    LONG_MAX);
+  unsigned char* b = new unsigned char[newHeld];
+  if(used > 0) memcpy(b, arena, used);
+  delete []arena;
+  arena = b;
+  held = newHeld;
+}
+
+int StringStash::add(const char* s, long length) {
+  assert(length >= 0);
+  require(length <= LONG_MAX - used,
+    "StringStash::add: arena too large");
+  if(used + length > held)
+    inflate(used + length);
+  Entry e = { used, length };
+  if(length > 0) memcpy(arena + used, s, length);
+  used += length;
+  return index.add(&e);
+}
+
+string_view StringStash::fetch(int i) {
+  Entry* e = (Entry*)index.fetch(i);
+  if(e == 0)
+    return string_view(); // To indicate the end
+  if(e->length == 0)
+    return string_view("", 0);
+  return string_view(
+    (char*)arena + e->offset, e->length);
+}
+
+void StringStash::shrinkToFit() {
+  if(used < held) {
+    unsigned char* b = 0;
+    if(used > 0) {
+      b = new unsigned char[used];
+      memcpy(b, arena, used);
+    }
+    delete []arena;
+    arena = b;
+    held = used;
+  }
+  index.shrinkToFit();
+} ///:~
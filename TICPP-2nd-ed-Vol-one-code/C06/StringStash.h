@@ -0,0 +1,47 @@
+//: C06:StringStash.h
+// Variable-length strings packed end to end in
+// one byte arena, with an (offset, length)
+// index. No fixed slot: short lines waste
+// nothing and long lines are never truncated.
+// The arena counts its bytes in long, not in a
+// Stash's int, so it can hold more than 2 GB.
+// A view from fetch() is valid until the next
+// add(), which may move the arena.
+#ifndef STRINGSTASH_H
+#define STRINGSTASH_H
+#include "Stash2.h"
+#include <string>
+#include <string_view>
+
+class StringStash {
+  struct Entry {
+    long offset; // Start of the string in arena
+    long length;
+  };
+  unsigned char* arena; // The bytes of every string
+  long used, held; // Bytes of arena
+  Growth growth;
+  Stash index; // One Entry per string
+  void inflate(long minBytes);
+  StringStash(const StringStash&);
+  void operator=(const StringStash&);
+public:
+  StringStash(Growth g = geometricGrowth())
+    : arena(0), used(0), held(0), growth(g),
+      index(sizeof(Entry), g) {}
+  ~StringStash() { delete []arena; }
+  int add(const char* s, long length);
+  int add(const std::string& s) {
+    return add(s.data(), long(s.size()));
+  }
+  // Past the end, the view has a null data():
+  std::string_view fetch(int i);
+  int count() { return index.count(); }
+  // Bytes of storage held (arena plus index):
+  long bytes() const {
+    return held +
+      long(index.capacity()) * sizeof(Entry);
+  }
+  void shrinkToFit();
+};
+#endif // STRINGSTASH_H ///:~
@@ -0,0 +1,33 @@
+//: C06:StringStashTest.cpp
+//{L} StringStash Stash2
+// Stash2Test's stringStash without the fixed
+// 80-byte slots
+#include "StringStash.h"
+#include "../require.h"
+#include <fstream>
+#include <iostream>
+#include <string>
+using namespace std;
+
+int main() {
+  StringStash stringStash;
+  ifstream in("StringStashTest.cpp");
+  assure(in, "StringStashTest.cpp");
+  string line;
+  while(getline(in, line))
+    stringStash.add(line);
+  // Longer than the old 80-byte slot:
+  string longLine(200, '*');
+  int longIndex = stringStash.add(longLine);
+  int k = 0;
+  string_view sv;
+  while((sv = stringStash.fetch(k++)).data() != 0)
+    cout << "stringStash.fetch(" << k << ") = "
+         << sv << endl;
+  require(stringStash.fetch(longIndex) == longLine,
+    "StringStashTest: long line truncated");
+  require(stringStash.add("", 0) == longIndex + 1,
+    "StringStashTest: empty string index");
+  require(stringStash.fetch(longIndex + 1).empty(),
+    "StringStashTest: empty string not empty");
+} ///:~
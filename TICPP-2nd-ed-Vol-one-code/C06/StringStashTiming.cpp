@@ -0,0 +1,82 @@
+//: C06:StringStashTiming.cpp
+//{L} StringStash Stash2
+// Load a log file into 80-byte Stash slots and
+// into a StringStash; report time, throughput,
+// storage held and lines the slots truncated.
+// Usage: StringStashTiming [logFile]
+// Without a file, a synthetic log is generated.
+#include "StringStash.h"
+#include "../Stopwatch.h"
+#include "../require.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+using namespace std;
+
+const int bufsize = 80;
+
+void report(const char* name, double secs,
+  long inputBytes, long heldBytes, int lines) {
+  cout << name << ": " << lines << " lines, "
+       << secs << " s, "
+       << inputBytes / secs / 1e6 << " MB/s, "
+       << heldBytes / 1e6 << " MB held" << endl;
+}
+
+int main(int argc, char* argv[]) {
+  string fileName = "StringStashTiming.log";
+  bool generated = argc < 2;
+  if(!generated)
+    fileName = argv[1];
+  else { // Mostly short lines, a few long ones
+    ofstream out(fileName.c_str());
+    assure(out, fileName);
+    srand(47);
+    for(int i = 0; i < 1000000; i++) {
+      int len = i % 20 ? 10 + rand() % 60
+        : 100 + rand() % 400;
+      out << i << ' ' << string(len, 'a' + i % 26)
+          << '\n';
+    }
+  }
+  long inputBytes = 0;
+  {
+    ifstream in(fileName.c_str());
+    assure(in, fileName);
+    Stash slots(sizeof(char) * bufsize,
+      geometricGrowth());
+    string line;
+    char buf[bufsize];
+    int truncated = 0;
+    Stopwatch sw;
+    while(getline(in, line)) {
+      inputBytes += line.size() + 1;
+      if(line.size() >= bufsize) truncated++;
+      strncpy(buf, line.c_str(), bufsize - 1);
+      buf[bufsize - 1] = 0;
+      slots.add(buf);
+    }
+    report("80-byte slots", sw.seconds(), inputBytes,
+      long(slots.capacity()) * bufsize,
+      slots.count());
+    cout << "  truncated lines: " << truncated << endl;
+  }
+  {
+    ifstream in(fileName.c_str());
+    StringStash strings;
+    string line;
+    Stopwatch sw;
+    while(getline(in, line))
+      strings.add(line);
+    report("StringStash", sw.seconds(), inputBytes,
+      strings.bytes(), strings.count());
+    strings.shrinkToFit();
+    cout << "  after shrinkToFit: "
+         << strings.bytes() / 1e6 << " MB" << endl;
+  }
+  if(generated)
+    remove(fileName.c_str());
+} ///:~
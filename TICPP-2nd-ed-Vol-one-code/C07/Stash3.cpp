@@ -5,24 +5,26 @@
 // Copyright notice in Copyright.txt
 // Function overloading
 #include "Stash3.h"
+#include "../CopyBytes.h"
 #include "../require.h"
 #include <iostream>
 #include <cassert>
 using namespace std;
-const int increment = 100;
 
-Stash::Stash(int sz) {
+Stash::Stash(int sz, Growth g) {
   size = sz;
   quantity = 0;
   next = 0;
   storage = 0;
+  growth = g;
 }
 
-Stash::Stash(int sz, int initQuantity) {
+Stash::Stash(int sz, int initQuantity, Growth g) {
   size = sz;
   quantity = 0;
   next = 0;
   storage = 0;
+  growth = g;
   inflate(initQuantity);
 }
 
@@ -35,17 +37,29 @@ Stash::~Stash() {
 
 int Stash::add(void* element) {
   if(next >= quantity) // Enough space left?
-    inflate(increment);
+    inflate(growth.grow(quantity, next + 1, size)
+      - quantity);
   // Copy element into storage,
   // starting at next empty space:
   int startBytes = next * size;
-  unsigned char* e = (unsigned char*)element;
-  for(int i = 0; i < size; i++)
-    storage[startBytes + i] = e[i];
+  copyBytes(&storage[startBytes], element, size);
   next++;
   return(next - 1); // Index number
 }
 
+// Append n contiguous elements in one copy:
+int Stash::addN(const void* elements, int n) {
+  assert(n >= 0);
+  if(next + n > quantity)
+    inflate(growth.grow(quantity, next + n, size)
+      - quantity);
+  int first = next;
+  copyBytes(&storage[first * size], elements,
+    n * size);
+  next += n;
+  return first; // Index of the first element
+}
+
 void* Stash::fetch(int index) {
   require(0 <= index, "Stash::fetch (-)index");
   if(index >= next)
@@ -58,6 +72,24 @@ int Stash::count() {
   return next; // Number of elements in CStash
 }
 
+void Stash::reserve(int n) {
+  if(n > quantity)
+    inflate(n - quantity);
+}
+
+void Stash::shrinkToFit() {
+  if(next == quantity) return;
+  unsigned char* b = 0;
+  int bytes = next * size;
+  if(bytes > 0) {
+    b = new unsigned char[bytes];
+    copyBytes(b, storage, bytes);
+  }
+  delete [](storage);
+  storage = b;
+  quantity = next;
+}
+
 void Stash::inflate(int increase) {
   assert(increase >= 0);
   if(increase == 0) return;
@@ -65,8 +97,7 @@ void Stash::inflate(int increase) {
   int newBytes = newQuantity * size;
   int oldBytes = quantity * size;
   unsigned char* b = new unsigned char[newBytes];
-  for(int i = 0; i < oldBytes; i++)
-    b[i] = storage[i]; // Copy old to new
+  copyBytes(b, storage, oldBytes); // Old to new
   delete [](storage); // Release old storage
   storage = b; // Point to new memory
   quantity = newQuantity; // Adjust the size
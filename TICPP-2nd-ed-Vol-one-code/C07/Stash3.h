@@ -6,6 +6,7 @@
 // Function overloading
 #ifndef STASH3_H
 #define STASH3_H
+#include "../Growth.h"
 
 class Stash {
   int size;      // Size of each space
@@ -13,13 +14,19 @@ class Stash {
   int next;      // Next empty space
   // Dynamically allocated array of bytes:
   unsigned char* storage;
+  Growth growth; // How inflate() sizes storage
   void inflate(int increase);
 public:
-  Stash(int size); // Zero quantity
-  Stash(int size, int initQuantity);
+  // Zero quantity:
+  Stash(int size, Growth growth = fixedGrowth());
+  Stash(int size, int initQuantity,
+    Growth growth = fixedGrowth());
   ~Stash();
   int add(void* element);
+  int addN(const void* elements, int n);
   void* fetch(int index);
   int count();
+  void reserve(int quantity);
+  void shrinkToFit();
 };
 #endif // STASH3_H ///:~
@@ -16,6 +16,11 @@ int main() {
   Stash intStash(sizeof(int));
   for(int i = 0; i < 100; i++)
     intStash.add(&i);
+  // Append a whole block with a single copy:
+  int block[] = { 100, 101, 102, 103, 104 };
+  const int bsz = sizeof block / sizeof *block;
+  require(intStash.addN(block, bsz) == 100,
+    "Stash3Test: addN index");
   for(int j = 0; j < intStash.count(); j++)
     cout << "intStash.fetch(" << j << ") = "
          << *(int*)intStash.fetch(j)
@@ -7,6 +7,7 @@
 #ifndef STACK4_H
 #define STACK4_H
 #include "../require.h"
+#include "../NodePool.h"
 
 class Stack {
   struct Link {
@@ -15,13 +16,14 @@ class Stack {
     Link(void* dat, Link* nxt): 
       data(dat), next(nxt) {}
   }* head;
+  NodePool<Link> pool; // This stack's Links
 public:
   Stack() : head(0) {}
   ~Stack() {
     require(head == 0, "Stack not empty");
   }
   void push(void* dat) {
-    head = new Link(dat, head);
+    head = pool.create(dat, head);
   }
   void* peek() const { 
     return head ? head->data : 0;
@@ -31,7 +33,7 @@ public:
     void* result = head->data;
     Link* oldHead = head;
     head = head->next;
-    delete oldHead;
+    pool.destroy(oldHead);
     return result;
   }
 };
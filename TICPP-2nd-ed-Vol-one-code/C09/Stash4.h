@@ -7,6 +7,7 @@
 #ifndef STASH4_H
 #define STASH4_H
 #include "../require.h"
+#include "../Growth.h"
 
 class Stash {
   int size;      // Size of each space
@@ -14,19 +15,23 @@ class Stash {
   int next;      // Next empty space
   // Dynamically allocated array of bytes:
   unsigned char* storage;
+  Growth growth; // How inflate() sizes storage
   void inflate(int increase);
 public:
-  Stash(int sz) : size(sz), quantity(0),
-    next(0), storage(0) {}
-  Stash(int sz, int initQuantity) : size(sz), 
-    quantity(0), next(0), storage(0) { 
+  Stash(int sz, Growth g = fixedGrowth())
+    : size(sz), quantity(0), next(0), storage(0),
+    growth(g) {}
+  Stash(int sz, int initQuantity,
+    Growth g = fixedGrowth()) : size(sz),
+    quantity(0), next(0), storage(0), growth(g) {
     inflate(initQuantity); 
   }
-  Stash::~Stash() {
+  ~Stash() {
     if(storage != 0) 
       delete []storage;
   }
   int add(void* element);
+  int addN(const void* elements, int n);
   void* fetch(int index) const {
     require(0 <= index, "Stash::fetch (-)index");
     if(index >= next)
@@ -35,5 +40,11 @@ public:
     return &(storage[index * size]);
   }
   int count() const { return next; }
+  int capacity() const { return quantity; }
+  void reserve(int n) {
+    if(n > quantity)
+      inflate(n - quantity);
+  }
+  void shrinkToFit();
 };
 #endif // STASH4_H ///:~
@@ -0,0 +1,55 @@
+//: C09:StashGrowth.cpp
+//{L} Stash4
+// Time add() under each growth policy. With
+// fixedGrowth the cost per add() climbs with
+// the element count; geometric and paged stay
+// flat (amortized constant time).
+// Usage: StashGrowth [maxElements [maxFixed]]
+#include "Stash4.h"
+#include "../Stopwatch.h"
+#include "../require.h"
+#include <cstdlib>
+#include <iostream>
+using namespace std;
+
+double timeAdds(Growth g, int n) {
+  Stash s(sizeof(int), g);
+  Stopwatch sw;
+  for(int i = 0; i < n; i++)
+    s.add(&i);
+  double ns = sw.nanosPer(n);
+  require(s.count() == n, "StashGrowth: lost adds");
+  require(*(int*)s.fetch(n - 1) == n - 1,
+    "StashGrowth: bad last element");
+  return ns;
+}
+
+int main(int argc, char* argv[]) {
+  int maxN = 10000000, maxFixed = 100000;
+  if(argc > 1) maxN = atoi(argv[1]);
+  if(argc > 2) maxFixed = atoi(argv[2]);
+  require(maxN > 0, "StashGrowth: bad count");
+  cout << "elements\tfixed(100)\tgeometric(2)"
+          "\tpaged(4K)  [ns per add]" << endl;
+  for(int n = 1000; n <= maxN; n *= 10) {
+    cout << n << "\t";
+    if(n <= maxFixed)
+      cout << timeAdds(fixedGrowth(), n);
+    else
+      cout << "-";
+    cout << "\t" << timeAdds(geometricGrowth(), n)
+         << "\t" << timeAdds(pagedGrowth(), n)
+         << endl;
+  }
+  // reserve() removes reallocation entirely:
+  Stash r(sizeof(int), geometricGrowth());
+  r.reserve(maxN);
+  Stopwatch sw;
+  for(int i = 0; i < maxN; i++)
+    r.add(&i);
+  cout << "reserved(" << maxN << ")\t"
+       << sw.nanosPer(maxN) << endl;
+  r.shrinkToFit();
+  require(r.capacity() == r.count(),
+    "StashGrowth: shrinkToFit left slack");
+} ///:~
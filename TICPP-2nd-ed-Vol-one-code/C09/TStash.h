@@ -0,0 +1,184 @@
+//: C09:TStash.h
+// Type-safe Stash: elements of T are stored
+// contiguously and constructed in place, so
+// non-trivial types (string, vector) are safe
+// and fetch() needs no cast. Growth moves the
+// elements; trivially copyable types take a
+// single memcpy instead.
+#ifndef TSTASH_H
+#define TSTASH_H
+#include "../require.h"
+#include "../Growth.h"
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+template<class T>
+class Stash {
+  int quantity;  // Number of storage spaces
+  int next;      // Next empty space
+  T* storage;    // Raw memory; [0, next) is live
+  Growth growth; // How inflate() sizes storage
+  static T* allocate(int n) {
+    return n > 0 ? static_cast<T*>(
+      ::operator new(n * sizeof(T))) : 0;
+  }
+  // Move n live elements from src to raw dest.
+  // If a copy throws, the copies made so far are
+  // destroyed and src is left as it was; the old
+  // elements are destroyed only once all of them
+  // are in dest:
+  static void relocate(T* dest, T* src, int n) {
+    if(std::is_trivially_copyable<T>::value) {
+      if(n > 0)
+        std::memcpy((void*)dest, (const void*)src,
+          n * sizeof(T));
+      return;
+    }
+    int i = 0;
+    try {
+      for(; i < n; i++)
+        ::new(static_cast<void*>(dest + i))
+          T(std::move_if_noexcept(src[i]));
+    } catch(...) {
+      while(i > 0) dest[--i].~T();
+      throw;
+    }
+    for(i = 0; i < n; i++)
+      src[i].~T();
+  }
+  void reallocate(int newQuantity) {
+    T* b = allocate(newQuantity);
+    try {
+      relocate(b, storage, next);
+    } catch(...) {
+      ::operator delete(b);
+      throw;
+    }
+    ::operator delete(storage);
+    storage = b;
+    quantity = newQuantity;
+  }
+  void inflate(int increase) {
+    require(increase > 0,
+      "Stash::inflate zero or negative increase");
+    reallocate(quantity + increase);
+  }
+  void makeRoom() {
+    if(next >= quantity)
+      inflate(growth.grow(quantity, next + 1,
+        sizeof(T)) - quantity);
+  }
+  Stash(const Stash&);            // Not copyable
+  Stash& operator=(const Stash&);
+public:
+  Stash(Growth g = geometricGrowth())
+    : quantity(0), next(0), storage(0),
+    growth(g) {}
+  Stash(int initQuantity,
+    Growth g = geometricGrowth())
+    : quantity(0), next(0), storage(0),
+    growth(g) {
+    reserve(initQuantity);
+  }
+  Stash(Stash&& rv) : quantity(rv.quantity),
+    next(rv.next), storage(rv.storage),
+    growth(rv.growth) {
+    rv.quantity = rv.next = 0;
+    rv.storage = 0;
+  }
+  ~Stash() {
+    clear();
+    ::operator delete(storage);
+  }
+  int add(const T& element) {
+    if(next >= quantity) {
+      // element may live in storage; copy it
+      // out before the storage moves:
+      T tmp(element);
+      makeRoom();
+      ::new(static_cast<void*>(storage + next))
+        T(std::move(tmp));
+    } else
+      ::new(static_cast<void*>(storage + next))
+        T(element);
+    return next++; // Index number
+  }
+  int add(T&& element) {
+    if(next >= quantity) {
+      T tmp(std::move(element));
+      makeRoom();
+      ::new(static_cast<void*>(storage + next))
+        T(std::move(tmp));
+    } else
+      ::new(static_cast<void*>(storage + next))
+        T(std::move(element));
+    return next++;
+  }
+  // Construct the new element in place:
+  template<class... Args>
+  int emplace(Args&&... args) {
+    if(next < quantity) {
+      ::new(static_cast<void*>(storage + next))
+        T(std::forward<Args>(args)...);
+      return next++;
+    }
+    // args may refer to elements, so build the
+    // new one in the new storage before the old
+    // elements move out:
+    int newQuantity = growth.grow(quantity,
+      next + 1, sizeof(T));
+    T* b = allocate(newQuantity);
+    try {
+      ::new(static_cast<void*>(b + next))
+        T(std::forward<Args>(args)...);
+    } catch(...) {
+      ::operator delete(b);
+      throw;
+    }
+    try {
+      relocate(b, storage, next);
+    } catch(...) {
+      b[next].~T();
+      ::operator delete(b);
+      throw;
+    }
+    ::operator delete(storage);
+    storage = b;
+    quantity = newQuantity;
+    return next++;
+  }
+  T* fetch(int index) {
+    require(0 <= index, "Stash::fetch (-)index");
+    if(index >= next)
+      return 0; // To indicate the end
+    return storage + index;
+  }
+  const T* fetch(int index) const {
+    return const_cast<Stash*>(this)->fetch(index);
+  }
+  T& operator[](int index) {
+    require(0 <= index && index < next,
+      "Stash::operator[] index out of range");
+    return storage[index];
+  }
+  int count() const { return next; }
+  int capacity() const { return quantity; }
+  void reserve(int n) {
+    if(n > quantity)
+      inflate(n - quantity);
+  }
+  void shrinkToFit() {
+    if(next < quantity)
+      reallocate(next);
+  }
+  // Destroy every element, keep the storage:
+  void clear() {
+    if(!std::is_trivially_destructible<T>::value)
+      for(int i = 0; i < next; i++)
+        storage[i].~T();
+    next = 0;
+  }
+};
+#endif // TSTASH_H ///:~
@@ -0,0 +1,104 @@
+//: C09:TStashTest.cpp
+// Stash3Test ported to the type-safe Stash:
+// no casts, and each line is stored whole as a
+// string instead of in a fixed 80-byte slot.
+#include "TStash.h"
+#include "../require.h"
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+// Move-only element type:
+class Line {
+  vector<char> text;
+  Line(const Line&);
+public:
+  Line(const string& s) : text(s.begin(), s.end()) {}
+  Line(Line&& rv) noexcept : text(move(rv.text)) {}
+  string str() const {
+    return string(text.begin(), text.end());
+  }
+};
+
+// Its move isn't noexcept, so growth copies it,
+// and the copy can be made to throw:
+struct Fragile {
+  static int live, copiesLeft; // 0: never throw
+  int v;
+  Fragile(int i) : v(i) { live++; }
+  Fragile(const Fragile& f) : v(f.v) {
+    if(copiesLeft > 0 && --copiesLeft == 0)
+      throw 47;
+    live++;
+  }
+  ~Fragile() { live--; }
+};
+int Fragile::live = 0, Fragile::copiesLeft = 0;
+
+int main() {
+  Stash<int> intStash;
+  for(int i = 0; i < 100; i++)
+    intStash.add(i);
+  for(int j = 0; j < intStash.count(); j++)
+    cout << "intStash.fetch(" << j << ") = "
+         << *intStash.fetch(j)
+         << endl;
+  Stash<string> stringStash(100);
+  ifstream in("TStashTest.cpp");
+  assure(in, "TStashTest.cpp");
+  string line;
+  while(getline(in, line))
+    stringStash.add(line);
+  int k = 0;
+  string* sp;
+  while((sp = stringStash.fetch(k++)) != 0)
+    cout << "stringStash.fetch(" << k << ") = "
+         << *sp << endl;
+  // Growth moves move-only elements:
+  Stash<Line> lines(1);
+  for(int i = 0; i < stringStash.count(); i++)
+    lines.emplace(stringStash[i]);
+  require(lines.count() == stringStash.count(),
+    "TStashTest: emplace count");
+  for(int i = 0; i < lines.count(); i++)
+    require(lines[i].str() == stringStash[i],
+      "TStashTest: moved element differs");
+  lines.shrinkToFit();
+  require(lines.capacity() == lines.count(),
+    "TStashTest: shrinkToFit left slack");
+  // An element copied into the stash as it grows:
+  Stash<string> copies(1);
+  copies.add(string(100, 'c'));
+  for(int i = 1; i <= 10; i++) {
+    copies.emplace(copies[i - 1]); // Grows at 1, 2, 4, 8
+    require(copies[i] == copies[0],
+      "TStashTest: emplace from own element");
+  }
+  // A copy that throws during growth leaves the
+  // stash as it was:
+  {
+    Stash<Fragile> f(4);
+    for(int i = 0; i < 4; i++)
+      f.emplace(i);
+    Fragile::copiesLeft = 3;
+    bool thrown = false;
+    try {
+      f.emplace(4);
+    } catch(int) {
+      thrown = true;
+    }
+    require(thrown && f.count() == 4 &&
+      Fragile::live == 4,
+      "TStashTest: throwing copy lost elements");
+    for(int i = 0; i < f.count(); i++)
+      require(f[i].v == i,
+        "TStashTest: throwing copy changed elements");
+    f.emplace(4);
+    require(f.count() == 5 && f[4].v == 4,
+      "TStashTest: emplace after throw");
+  }
+  require(Fragile::live == 0,
+    "TStashTest: Fragile leaked");
+} ///:~
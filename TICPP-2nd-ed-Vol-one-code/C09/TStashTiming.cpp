@@ -0,0 +1,61 @@
+//: C09:TStashTiming.cpp
+// Time the type-safe Stash. The int column runs
+// the same workload as the geometric column of
+// StashGrowth (the byte-oriented Stash). The
+// Record column stores trivially copyable
+// 80-byte records (the memcpy path); the string
+// column builds 80-byte strings in place with
+// emplace() and moves them on growth.
+// Usage: TStashTiming [maxElements]
+#include "TStash.h"
+#include "../Stopwatch.h"
+#include "../require.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+using namespace std;
+
+struct Record { char text[80]; };
+
+double timeInts(int n) {
+  Stash<int> s;
+  Stopwatch sw;
+  for(int i = 0; i < n; i++)
+    s.add(i);
+  double ns = sw.nanosPer(n);
+  require(*s.fetch(n - 1) == n - 1,
+    "TStashTiming: bad last int");
+  return ns;
+}
+
+double timeRecords(int n) {
+  Stash<Record> s;
+  Record r;
+  memset(r.text, 'x', sizeof r.text);
+  r.text[sizeof r.text - 1] = 0;
+  Stopwatch sw;
+  for(int i = 0; i < n; i++)
+    s.add(r);
+  return sw.nanosPer(n);
+}
+
+double timeStrings(int n) {
+  Stash<string> s;
+  Stopwatch sw;
+  for(int i = 0; i < n; i++)
+    s.emplace(79, 'x');
+  return sw.nanosPer(n);
+}
+
+int main(int argc, char* argv[]) {
+  int maxN = 10000000;
+  if(argc > 1) maxN = atoi(argv[1]);
+  require(maxN > 0, "TStashTiming: bad count");
+  cout << "elements\tStash<int>\tStash<Record>"
+          "\tStash<string>  [ns per add]" << endl;
+  for(int n = 1000; n <= maxN; n *= 10)
+    cout << n << "\t" << timeInts(n) << "\t"
+         << timeRecords(n) << "\t"
+         << timeStrings(n) << endl;
+} ///:~
@@ -3,7 +3,9 @@
 // Available at http://www.BruceEckel.com
 // (c) Bruce Eckel 2000
 // Copyright notice in Copyright.txt
-// The copy-constructor
+// The copy-constructor. Output goes through
+// TRACE, with out as the sink.
+#include "../Trace.h"
 #include <fstream>
 #include <string>
 using namespace std;
@@ -29,10 +31,10 @@ public:
   }
   void print(const string& msg = "") const {
     if(msg.size() != 0) 
-      out << msg << endl;
-    out << '\t' << name << ": "
+      TRACE(msg);
+    TRACE('\t' << name << ": "
         << "objectCount = "
-        << objectCount << endl;
+        << objectCount);
   }
 };
 
@@ -41,16 +43,17 @@ int HowMany2::objectCount = 0;
 // Pass and return BY VALUE:
 HowMany2 f(HowMany2 x) {
   x.print("x argument inside f()");
-  out << "Returning from f()" << endl;
+  TRACE("Returning from f()");
   return x;
 }
 
 int main() {
+  Trace::sink() = &out;
   HowMany2 h("h");
-  out << "Entering f()" << endl;
+  TRACE("Entering f()");
   HowMany2 h2 = f(h);
   h2.print("h2 after call to f()");
-  out << "Call f(), no return value" << endl;
+  TRACE("Call f(), no return value");
   f(h);
-  out << "After call to f()" << endl;
+  TRACE("After call to f()");
 } ///:~
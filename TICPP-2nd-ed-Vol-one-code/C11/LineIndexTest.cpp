@@ -0,0 +1,120 @@
+//: C11:LineIndexTest.cpp
+// LineIndex agrees with getline() and keeps its
+// index file up to date: reused when nothing
+// changed, extended when the file grows,
+// rebuilt when it is rewritten or its index
+// is damaged.
+#include "../LineIndex.h"
+#include "../require.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+const char* name = "LineIndexTest.txt";
+
+void check(const LineIndex& index,
+  LineIndex::Built expected, const char* what) {
+  ifstream in(name);
+  vector<string> lines;
+  string line;
+  while(getline(in, line))
+    lines.push_back(line);
+  require(index.built() == expected,
+    string(what) + ": index opened wrongly");
+  require(index.lines() == lines.size(),
+    string(what) + ": wrong line count");
+  for(size_t i = 0; i < lines.size(); i++)
+    require(index[i] == lines[i],
+      string(what) + ": wrong line");
+  cout << what << ": " << index.lines()
+       << " lines, " << index.scanned()
+       << " bytes scanned" << endl;
+}
+
+// Write to the text file, appending by default:
+void put(const char* text,
+  const char* mode = "a") {
+  FILE* f = fopen(name, mode);
+  require(f != 0, name);
+  fputs(text, f);
+  fclose(f);
+}
+
+// Overwrite 8 bytes of the index file:
+void patch(long at, unsigned long long v) {
+  string index = string(name) + ".lines";
+  FILE* f = fopen(index.c_str(), "r+b");
+  require(f != 0, index);
+  fseek(f, at, SEEK_SET);
+  fwrite(&v, sizeof v, 1, f);
+  fclose(f);
+}
+
+int main() {
+  put("", "w");
+  {
+    LineIndex i(name);
+    check(i, LineIndex::rebuilt, "empty");
+  }
+  string text;
+  for(int i = 0; i < 1000; i++)
+    text += "line " + to_string(i) +
+      string(i % 70, '.') + "\n";
+  put(text.c_str());
+  {
+    LineIndex i(name);
+    check(i, LineIndex::appended, "written");
+  }
+  {
+    LineIndex i(name);
+    check(i, LineIndex::opened, "reopened");
+  }
+  require(LineIndex(name).scanned() == 0,
+    "reopened: text scanned");
+  // An unfinished last line, then its end:
+  put("no newline yet");
+  {
+    LineIndex i(name);
+    check(i, LineIndex::appended, "appended");
+  }
+  put(" ... now\n\nand more\n");
+  {
+    LineIndex i(name);
+    check(i, LineIndex::appended, "appended");
+  }
+  // Same size, other bytes:
+  text[10] = '#';
+  put(text.c_str(), "r+");
+  {
+    LineIndex i(name);
+    check(i, LineIndex::rebuilt, "rewritten");
+  }
+  put("short\n", "w");
+  {
+    LineIndex i(name);
+    check(i, LineIndex::rebuilt, "truncated");
+  }
+  // A line count that wraps to the one offset
+  // there is when multiplied by 8, then an
+  // offset past the text. The header is 168
+  // bytes; its line count is at 16:
+  patch(16, (1ULL << 61) + 1);
+  {
+    LineIndex i(name);
+    check(i, LineIndex::rebuilt, "line count");
+  }
+  patch(168, 1000);
+  {
+    LineIndex i(name);
+    check(i, LineIndex::rebuilt, "offset");
+  }
+  {
+    LineIndex i(name, "no/such/directory/index");
+    check(i, LineIndex::inMemory, "no index file");
+  }
+  remove(name);
+  remove((string(name) + ".lines").c_str());
+} ///:~
@@ -0,0 +1,131 @@
+//: C11:LineIndexTiming.cpp
+// Linenum.cpp's old way, every line read into a
+// vector<string>, against a LineIndex: building
+// it, opening it again, extending it after an
+// append, and walking it backwards and at random
+// as DisplayFileLines does. Peak memory is shown
+// after each; the index runs first, so its peak
+// isn't the vector's. A file given by name is
+// only read: the append is timed only on a
+// generated file, and the index is kept in
+// LineIndexTiming.lines.
+// Usage: LineIndexTiming [megabytes [file]]
+#include "../LineIndex.h"
+#include "../Newlines.h"
+#include "../Stopwatch.h"
+#include "../require.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+using namespace std;
+
+long peakMB() {
+  struct rusage ru;
+  getrusage(RUSAGE_SELF, &ru);
+  return ru.ru_maxrss / 1024;
+}
+
+void writeText(const char* name, long bytes) {
+  ofstream out(name);
+  assure(out, name);
+  srand(47);
+  long written = 0;
+  while(written < bytes) {
+    string line(rand() % 120, 'x');
+    out << line << '\n';
+    written += line.size() + 1;
+  }
+}
+
+int main(int argc, char* argv[]) {
+  long megabytes = 256;
+  string name = "LineIndexTiming.txt";
+  if(argc > 1) megabytes = atol(argv[1]);
+  if(argc > 2) name = argv[2];
+  else {
+    require(megabytes > 0,
+      "LineIndexTiming: bad size");
+    writeText(name.c_str(), megabytes << 20);
+  }
+  const bool generated = argc <= 2;
+  const string indexName = "LineIndexTiming.lines";
+  remove(indexName.c_str());
+  Stopwatch sw;
+  size_t lines = 0;
+  {
+    MappedFile text(name);
+    require(!text.fail(), name);
+    cout << name << ": " << text.size() / 1e6
+         << " MB" << endl << "newline count GB/s:";
+    for(int isa = Words::scalar;
+      isa <= Words::detect(); isa++) {
+      sw.mark();
+      lines = Newlines::lines(text.data(),
+        text.size(), Words::Isa(isa));
+      cout << " " << Words::name(Words::Isa(isa))
+           << " " << text.size() / sw.seconds() / 1e9;
+    }
+    cout << endl;
+  }
+  sw.mark();
+  {
+    LineIndex index(name, indexName);
+    require(index.built() == LineIndex::rebuilt &&
+      index.lines() == lines, "build");
+  }
+  cout << "build index\t" << sw.seconds() * 1e3
+       << " ms, peak " << peakMB() << " MB" << endl;
+  sw.mark();
+  {
+    LineIndex index(name, indexName);
+    require(index.built() == LineIndex::opened,
+      "reopen");
+  }
+  cout << "reopen index\t" << sw.seconds() * 1e3
+       << " ms" << endl;
+  if(generated) {
+    ofstream out(name.c_str(), ios::app);
+    for(int i = 0; i < 1000; i++)
+      out << "appended line " << i << '\n';
+    lines += 1000;
+  }
+  sw.mark();
+  LineIndex index(name, indexName);
+  require(index.built() == (generated ?
+    LineIndex::appended : LineIndex::opened) &&
+    index.lines() == lines, "append");
+  if(generated)
+    cout << "after append\t" << sw.seconds() * 1e3
+         << " ms, " << index.scanned()
+         << " bytes scanned" << endl;
+  sw.mark();
+  size_t letters = 0;
+  for(size_t i = index.lines(); i-- > 0; )
+    letters += index[i].size();
+  cout << "reverse walk\t" << sw.seconds() * 1e3
+       << " ms" << endl;
+  sw.mark();
+  srand(11);
+  for(int i = 0; i < 1000000; i++)
+    letters += index[size_t(rand()) % lines].size();
+  cout << "1M random lines\t" << sw.seconds() * 1e3
+       << " ms, peak " << peakMB() << " MB" << endl;
+  sw.mark();
+  {
+    ifstream in(name.c_str());
+    vector<string> v;
+    string line;
+    while(getline(in, line))
+      v.push_back(line);
+    require(v.size() == lines, "getline");
+    for(size_t i = v.size(); i-- > 0; )
+      letters -= v[i].size();
+  }
+  cout << "vector<string>\t" << sw.seconds() * 1e3
+       << " ms, peak " << peakMB() << " MB" << endl;
+  cout << "(" << letters << ")" << endl;
+} ///:~
@@ -0,0 +1,176 @@
+//: C11:LineNumberer.h
+// Writes text to a file descriptor with each
+// line numbered as Linenum.cpp numbers it, but
+// with no iostream, no flush per line and no
+// allocation per line. The number is kept as
+// digits and counted up in place, so nothing is
+// divided. Short lines are copied after their
+// number into one large buffer; longer ones are
+// sent straight from the text. writev() writes
+// both in one system call.
+#ifndef LINENUMBERER_H
+#define LINENUMBERER_H
+#include "../MappedFile.h"
+#include "../Newlines.h"
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+#include <sys/uio.h>
+#include <unistd.h>
+
+class LineNumberer {
+  int fd;
+  std::vector<char> buf;
+  std::size_t used, sentUpTo; // Of buf
+  std::vector<iovec> iov;
+  // The number, right-aligned in spaces and
+  // followed by ") ", ends at digit + end:
+  enum { end = 24, longLine = 256 };
+  char digit[end + 2];
+  int width, digits;
+  bool ok;
+  static std::size_t chunk() { return 64 << 20; }
+  void next() {
+    int i = end - 1;
+    while(digit[i] == '9') digit[i--] = '0';
+    if(digit[i] == ' ') {
+      digit[i] = '1';
+      digits++;
+    } else
+      digit[i]++;
+  }
+  void bufferToIov() {
+    if(used > sentUpTo) {
+      iovec v = { &buf[sentUpTo], used - sentUpTo };
+      iov.push_back(v);
+    }
+    sentUpTo = used;
+  }
+  // Number one line of text, which lacks its
+  // '\n' if nl is false:
+  void line(const char* text, std::size_t n,
+    bool nl) {
+    int w = digits > width ? digits : width;
+    std::size_t prefix = w + 2;
+    bool copy = n <= longLine;
+    if(buf.size() - used <
+      prefix + (copy ? n : 0) + 1 ||
+      iov.size() + 2 >= IOV_MAX) flush();
+    std::memcpy(&buf[used], digit + end - w, prefix);
+    used += prefix;
+    if(copy) {
+      std::memcpy(&buf[used], text, n);
+      used += n;
+    } else {
+      bufferToIov();
+      iovec v = { const_cast<char*>(text), n };
+      iov.push_back(v);
+    }
+    if(!nl) buf[used++] = '\n';
+    next();
+  }
+  LineNumberer(const LineNumberer&);
+  void operator=(const LineNumberer&);
+public:
+  LineNumberer(int fileDescriptor, int numberWidth,
+    std::size_t bufferSize = 1 << 20)
+    : fd(fileDescriptor), buf(bufferSize),
+      used(0), sentUpTo(0), width(numberWidth),
+      ok(true) {
+    if(width > end - 1) width = end - 1;
+    std::memcpy(digit + end, ") ", 2);
+    start(1);
+  }
+  ~LineNumberer() { flush(); }
+  // The number for the next line:
+  void start(unsigned long long first) {
+    std::memset(digit, ' ', end);
+    digits = 0;
+    do {
+      digit[end - ++digits] = '0' + first % 10;
+      first /= 10;
+    } while(first > 0);
+  }
+  // Number every line in text[0, n); a last line
+  // without a '\n' gets one.
+  bool write(const char* text, std::size_t n) {
+    std::size_t begin = 0;
+    Newlines::each(text, n, [&](std::size_t i) {
+      line(text + begin, i + 1 - begin, true);
+      begin = i + 1;
+    });
+    if(begin < n) line(text + begin, n - begin, false);
+    return ok;
+  }
+  // The whole file, a chunk at a time, so that
+  // pages already written are given back: a
+  // file larger than RAM goes through in a
+  // fixed amount of memory.
+  bool write(MappedFile& file) {
+    const char* p = file.data();
+    std::size_t n = file.size(), from = 0;
+    while(from < n && ok) {
+      std::size_t to = n - from > chunk() ?
+        from + chunk() : n;
+      // Cut after the last '\n' in the chunk, or
+      // after the first one beyond it:
+      const void* nl = to == n ? 0 :
+        memrchr(p + from, '\n', to - from);
+      if(nl == 0 && to < n)
+        nl = std::memchr(p + to, '\n', n - to);
+      if(to < n)
+        to = nl ? static_cast<const char*>(nl) - p + 1
+          : n;
+      write(p + from, to - from);
+      flush(); // Before the text goes
+      file.release(from, to);
+      from = to;
+    }
+    return ok;
+  }
+  // Lines in the file, as Newlines::lines()
+  // counts them, a chunk at a time like write():
+  static std::size_t lines(MappedFile& file) {
+    const char* p = file.data();
+    std::size_t n = file.size(), total = 0;
+    for(std::size_t from = 0; from < n;
+      from += chunk()) {
+      std::size_t to = n - from > chunk() ?
+        from + chunk() : n;
+      total += Newlines::count(p + from, to - from);
+      file.release(from, to);
+    }
+    return total + (n > 0 && p[n - 1] != '\n');
+  }
+  // Write out everything buffered so far:
+  bool flush() {
+    bufferToIov();
+    std::size_t i = 0;
+    while(ok && i < iov.size()) {
+      int count = iov.size() - i > IOV_MAX ?
+        IOV_MAX : int(iov.size() - i);
+      ssize_t r = writev(fd, &iov[i], count);
+      if(r < 0) {
+        ok = errno == EINTR;
+        continue;
+      }
+      // Step over what was written, which may
+      // end partway through one iovec:
+      std::size_t done = r;
+      while(i < iov.size() && done >= iov[i].iov_len)
+        done -= iov[i++].iov_len;
+      if(done > 0) {
+        iov[i].iov_base =
+          static_cast<char*>(iov[i].iov_base) + done;
+        iov[i].iov_len -= done;
+      }
+    }
+    iov.clear();
+    used = sentUpTo = 0;
+    return ok;
+  }
+  bool fail() const { return !ok; }
+};
+#endif // LINENUMBERER_H ///:~
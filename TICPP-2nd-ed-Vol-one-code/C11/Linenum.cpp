@@ -4,32 +4,75 @@
 // (c) Bruce Eckel 2000
 // Copyright notice in Copyright.txt
 //{T} Linenum.cpp
-// Add line numbers
+// Add line numbers. The whole file is streamed
+// through a LineNumberer (see LineNumberer.h);
+// for part of it, give a first line and a count
+// and the lines are found with a LineIndex (see
+// LineIndex.h). Either way the file is mapped,
+// never held in strings, and may be larger than
+// RAM.
 #include "../require.h"
-#include <vector>
-#include <string>
-#include <fstream>
-#include <iostream>
+#include "../LineIndex.h"
+#include "../MappedFile.h"
+#include "LineNumberer.h"
+#include <cctype>
+#include <cstdlib>
 #include <cmath>
+#include <string_view>
+#include <unistd.h>
 using namespace std;
 
+// A line number or count: digits only.
+size_t number(const char* arg, const char* what) {
+  char* end = 0;
+  unsigned long n = strtoul(arg, &end, 10);
+  require(isdigit((unsigned char)arg[0]) &&
+    *end == 0, string("Linenum: bad ") + what);
+  return n;
+}
+
 int main(int argc, char* argv[]) {
-  requireArgs(argc, 1, "Usage: linenum file\n"
+  requireMinArgs(argc, 1,
+    "Usage: linenum file [first [count]]\n"
     "Adds line numbers to file");
-  ifstream in(argv[1]);
-  assure(in, argv[1]);
-  string line;
-  vector<string> lines;
-  while(getline(in, line)) // Read in entire file
-    lines.push_back(line);
-  if(lines.size() == 0) return 0;
-  int num = 0;
-  // Number of lines in file determines width:
-  const int width = 
-    int(log10((double)lines.size())) + 1;
-  for(int i = 0; i < lines.size(); i++) {
-    cout.setf(ios::right, ios::adjustfield);
-    cout.width(width);
-    cout << ++num << ") " << lines[i] << endl;
+  if(argc < 3) {
+    MappedFile text(argv[1]);
+    require(!text.fail(),
+      string("Could not open file ") + argv[1]);
+    size_t n = LineNumberer::lines(text);
+    if(n == 0) return 0;
+    // Number of lines in file determines width:
+    LineNumberer out(STDOUT_FILENO,
+      int(log10((double)n)) + 1);
+    require(out.write(text) && out.flush(),
+      "Linenum: write failed");
+    return 0;
+  }
+  LineIndex lines(argv[1]);
+  require(!lines.fail(),
+    string("Could not open file ") + argv[1]);
+  if(lines.lines() == 0) return 0;
+  size_t first = number(argv[2], "first line");
+  require(first > 0, "Linenum: lines start at 1");
+  require(first <= lines.lines(),
+    "Linenum: no such line");
+  first--;
+  size_t count = lines.lines() - first;
+  if(argc > 3) {
+    size_t asked = number(argv[3], "count");
+    require(asked > 0, "Linenum: count must be > 0");
+    if(asked < count) count = asked;
   }
+  size_t end = first + count;
+  LineNumberer out(STDOUT_FILENO,
+    int(log10((double)lines.lines())) + 1);
+  out.start(first + 1);
+  // The lines asked for are one run of text,
+  // up to the start of the next line:
+  const char* from = lines[first].data();
+  const char* to = end < lines.lines() ?
+    lines[end].data() :
+    lines.contents().data() + lines.contents().size();
+  require(out.write(from, to - from) && out.flush(),
+    "Linenum: write failed");
 } ///:~
@@ -0,0 +1,100 @@
+//: C11:LinenumTiming.cpp
+// Numbering every line of a file the old
+// Linenum.cpp way (getline, cout.width, endl)
+// against LineNumberer, and against nl -ba. All
+// write to /dev/null, so only the work of
+// reading and numbering is timed.
+// Usage: LinenumTiming [megabytes [file]]
+#include "LineNumberer.h"
+#include "../MappedFile.h"
+#include "../Stopwatch.h"
+#include "../require.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <unistd.h>
+using namespace std;
+
+long peakMB() {
+  struct rusage ru;
+  getrusage(RUSAGE_SELF, &ru);
+  return ru.ru_maxrss / 1024;
+}
+
+void writeText(const char* name, long bytes) {
+  ofstream out(name);
+  assure(out, name);
+  srand(47);
+  long written = 0;
+  while(written < bytes) {
+    string line(rand() % 120, 'x');
+    out << line << '\n';
+    written += line.size() + 1;
+  }
+}
+
+int main(int argc, char* argv[]) {
+  long megabytes = 256;
+  string name = "LinenumTiming.txt";
+  if(argc > 1) megabytes = atol(argv[1]);
+  if(argc > 2) name = argv[2];
+  else {
+    require(megabytes > 0,
+      "LinenumTiming: bad size");
+    writeText(name.c_str(), megabytes << 20);
+  }
+  Stopwatch sw;
+  double bytes;
+  {
+    MappedFile text(name);
+    require(!text.fail(), name);
+    bytes = text.size();
+    int fd = open("/dev/null", O_WRONLY);
+    require(fd >= 0, "/dev/null");
+    sw.mark();
+    size_t n = LineNumberer::lines(text);
+    LineNumberer out(fd, n ? int(log10(double(n))) + 1 : 1);
+    require(out.write(text) && out.flush(), "write");
+    double s = sw.seconds();
+    cout << name << ": " << bytes / 1e6 << " MB, "
+         << n << " lines" << endl;
+    cout << "LineNumberer\t" << s * 1e3 << " ms, "
+         << bytes / s / 1e9 << " GB/s, peak "
+         << peakMB() << " MB" << endl;
+    close(fd);
+  }
+  string nl = "nl -ba " + name + " > /dev/null";
+  sw.mark();
+  if(system(nl.c_str()) == 0) {
+    double s = sw.seconds();
+    cout << "nl -ba\t\t" << s * 1e3 << " ms, "
+         << bytes / s / 1e9 << " GB/s" << endl;
+  } else
+    cout << "nl -ba\t\tnot run" << endl;
+  sw.mark();
+  {
+    ifstream in(name.c_str());
+    ofstream out("/dev/null");
+    vector<string> lines;
+    string line;
+    while(getline(in, line))
+      lines.push_back(line);
+    const int width =
+      int(log10((double)lines.size())) + 1;
+    for(size_t i = 0; i < lines.size(); i++) {
+      out.setf(ios::right, ios::adjustfield);
+      out.width(width);
+      out << i + 1 << ") " << lines[i] << endl;
+    }
+  }
+  double s = sw.seconds();
+  cout << "cout, endl\t" << s * 1e3 << " ms, "
+       << bytes / s / 1e9 << " GB/s, peak "
+       << peakMB() << " MB" << endl;
+} ///:~
@@ -7,6 +7,7 @@
 // duplicating what is pointed to during 
 // assignment and copy-construction.
 #include "../require.h"
+#include "../Trace.h"
 #include <string>
 #include <iostream>
 using namespace std;
@@ -15,22 +16,22 @@ class Dog {
   string nm;
 public:
   Dog(const string& name) : nm(name) {
-    cout << "Creating Dog: " << *this << endl;
+    TRACE("Creating Dog: " << *this);
   }
   // Synthesized copy-constructor & operator= 
   // are correct.
   // Create a Dog from a Dog pointer:
   Dog(const Dog* dp, const string& msg) 
     : nm(dp->nm + msg) {
-    cout << "Copied dog " << *this << " from "
-         << *dp << endl;
+    TRACE("Copied dog " << *this << " from "
+         << *dp);
   }
   ~Dog() { 
-    cout << "Deleting Dog: " << *this << endl;
+    TRACE("Deleting Dog: " << *this);
   }
   void rename(const string& newName) {
     nm = newName;
-    cout << "Dog renamed to: " << *this << endl;
+    TRACE("Dog renamed to: " << *this);
   }
   friend ostream&
   operator<<(ostream& os, const Dog& d) {
@@ -70,14 +71,14 @@ public:
 
 int main() {
   DogHouse fidos(new Dog("Fido"), "FidoHouse");
-  cout << fidos << endl;
+  TRACE(fidos);
   DogHouse fidos2 = fidos; // Copy construction
-  cout << fidos2 << endl;
+  TRACE(fidos2);
   fidos2.getDog()->rename("Spot");
   fidos2.renameHouse("SpotHouse");
-  cout << fidos2 << endl;
+  TRACE(fidos2);
   fidos = fidos2; // Assignment
-  cout << fidos << endl;
+  TRACE(fidos);
   fidos.getDog()->rename("Max");
   fidos2.renameHouse("MaxHouse");
 } ///:~
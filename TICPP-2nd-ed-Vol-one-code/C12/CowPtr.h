@@ -0,0 +1,116 @@
+//: C12:CowPtr.h
+// DogHouse's reference counting and unalias(),
+// made generic. A CowPtr<T> shares one T with
+// every copy of itself; reading through it is
+// free and writing goes through write(), which
+// copies the T first only if it is shared. The
+// count is atomic, so handles to the same T may
+// be copied and dropped on different threads.
+// Giving a CowPtr a T by rvalue moves it in
+// rather than copying it.
+#ifndef COWPTR_H
+#define COWPTR_H
+#include "../require.h"
+#include <atomic>
+#include <type_traits>
+#include <utility>
+
+template<class T>
+class CowPtr {
+  struct Shared {
+    std::atomic<long> refcount;
+    T value;
+    template<class... Args>
+    Shared(Args&&... args) : refcount(1),
+      value(std::forward<Args>(args)...) {}
+  };
+  Shared* p;
+  void attach() {
+    if(p) p->refcount.fetch_add(1,
+      std::memory_order_relaxed);
+  }
+  void detach() {
+    // Destroy the T if no one else is using it:
+    if(p && p->refcount.fetch_sub(1,
+      std::memory_order_acq_rel) == 1)
+      delete p;
+    p = 0;
+  }
+  explicit CowPtr(Shared* s) : p(s) {}
+public:
+  template<class... Args>
+  static CowPtr make(Args&&... args) {
+    return CowPtr(new Shared(
+      std::forward<Args>(args)...));
+  }
+  CowPtr() : p(0) {}
+  CowPtr(const T& value) : p(new Shared(value)) {}
+  CowPtr(T&& value)
+    : p(new Shared(std::move(value))) {}
+  CowPtr(const CowPtr& rv) : p(rv.p) { attach(); }
+  CowPtr(CowPtr&& rv) noexcept : p(rv.p) {
+    rv.p = 0;
+  }
+  ~CowPtr() { detach(); }
+  CowPtr& operator=(const CowPtr& rv) {
+    if(p != rv.p) { // Includes self-assignment
+      CowPtr keep(rv); // rv may die in detach()
+      detach();
+      p = keep.p;
+      keep.p = 0;
+    }
+    return *this;
+  }
+  CowPtr& operator=(CowPtr&& rv) noexcept {
+    if(this != &rv) {
+      detach();
+      p = rv.p;
+      rv.p = 0;
+    }
+    return *this;
+  }
+  // Replace the value; reuses the T when this is
+  // the only handle:
+  CowPtr& operator=(T&& value) {
+    if(unique())
+      p->value = std::move(value);
+    else {
+      detach();
+      p = new Shared(std::move(value));
+    }
+    return *this;
+  }
+  CowPtr& operator=(const T& value) {
+    return *this = T(value);
+  }
+  const T& operator*() const { return p->value; }
+  const T* operator->() const { return &p->value; }
+  const T* get() const { return p ? &p->value : 0; }
+  // Conditionally copy, then allow changes. An
+  // empty (default or moved-from) handle gets a
+  // value-initialized T, if T has one:
+  T& write() {
+    if(p == 0) {
+      if constexpr(std::is_default_constructible<
+        T>::value)
+        p = new Shared();
+      else
+        require(false,
+          "CowPtr::write: no value to write");
+    } else if(!unique()) {
+      Shared* copy = new Shared(p->value);
+      detach();
+      p = copy;
+    }
+    return p->value;
+  }
+  bool unique() const {
+    return p && p->refcount.load(
+      std::memory_order_acquire) == 1;
+  }
+  long useCount() const {
+    return p ? p->refcount.load() : 0;
+  }
+  explicit operator bool() const { return p != 0; }
+};
+#endif // COWPTR_H ///:~
@@ -0,0 +1,122 @@
+//: C12:CowPtrTest.cpp
+// ReferenceCounting.cpp's DogHouses on CowPtr:
+// no attach(), detach() or unalias() by hand
+#include "CowPtr.h"
+#include "../require.h"
+#include <iostream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+using namespace std;
+
+class Dog {
+  string nm;
+public:
+  Dog(const string& name) : nm(name) {
+    cout << "Creating Dog: " << *this << endl;
+  }
+  Dog(const Dog& d) : nm(d.nm + " copy") {
+    cout << "Dog copy-constructor: "
+         << *this << endl;
+  }
+  Dog(Dog&& d) : nm(move(d.nm)) {
+    cout << "Dog moved: " << *this << endl;
+  }
+  Dog& operator=(Dog&& d) {
+    nm = move(d.nm);
+    cout << "Dog move-assigned: " << *this << endl;
+    return *this;
+  }
+  ~Dog() {
+    if(!nm.empty())
+      cout << "Deleting Dog: " << *this << endl;
+  }
+  void rename(const string& newName) {
+    nm = newName;
+    cout << "Dog renamed to: " << *this << endl;
+  }
+  friend ostream&
+  operator<<(ostream& os, const Dog& d) {
+    return os << "[" << d.nm << "]";
+  }
+};
+
+class DogHouse {
+  CowPtr<Dog> p;
+  string houseName;
+public:
+  DogHouse(CowPtr<Dog> dog, const string& house)
+    : p(move(dog)), houseName(house) {}
+  // Copy-constructor, operator= and destructor
+  // are synthesized correctly
+  void renameDog(const string& newName) {
+    p.write().rename(newName);
+  }
+  long sharing() const { return p.useCount(); }
+  friend ostream&
+  operator<<(ostream& os, const DogHouse& dh) {
+    return os << "[" << dh.houseName
+      << "] contains " << *dh.p << ", rc = "
+      << dh.sharing();
+  }
+};
+
+// So that a vector<CowPtr> moves its handles
+// instead of copying them as it grows:
+static_assert(is_nothrow_move_constructible<
+  CowPtr<Dog>>::value &&
+  is_nothrow_move_assignable<CowPtr<Dog>>::value,
+  "CowPtr moves may throw");
+
+int main() {
+  {
+    DogHouse
+      fidos(CowPtr<Dog>::make("Fido"), "FidoHouse"),
+      spots(CowPtr<Dog>::make("Spot"), "SpotHouse");
+    DogHouse bobs(fidos);
+    cout << "bobs:" << bobs << endl;
+    spots = fidos; // Spot is deleted here
+    require(fidos.sharing() == 3,
+      "CowPtrTest: not shared");
+    bobs = bobs;
+    cout << "Entering renameDog(\"Bob\")" << endl;
+    bobs.renameDog("Bob"); // Copies: shared
+    cout << "Entering renameDog(\"Rex\")" << endl;
+    bobs.renameDog("Rex"); // No copy: unique
+    require(bobs.sharing() == 1 &&
+      fidos.sharing() == 2,
+      "CowPtrTest: bad counts after write()");
+    cout << "fidos:" << fidos << endl;
+    cout << "bobs:" << bobs << endl;
+    CowPtr<Dog> dog(Dog("Max")); // Moved in
+    dog = Dog("Rover"); // Move-assigned in place
+    require(dog.unique(), "CowPtrTest: not unique");
+    CowPtr<string> empty;
+    empty.write() = "filled"; // Was no value
+    CowPtr<string> taken(move(empty));
+    empty.write() += "again"; // Moved from
+    require(*empty == "again" && *taken == "filled",
+      "CowPtrTest: write() on an empty handle");
+  }
+  // Handles to one string copied and dropped
+  // on several threads:
+  CowPtr<string> shared(string(1000, 'x'));
+  vector<thread> threads;
+  for(int t = 0; t < 4; t++)
+    threads.push_back(thread([&shared, t] {
+      for(int i = 0; i < 100000; i++) {
+        CowPtr<string> mine(shared);
+        if(i % 1000 == 0)
+          mine.write()[0] = char('a' + t);
+        require(mine->size() == 1000,
+          "CowPtrTest: bad size");
+      }
+    }));
+  for(size_t t = 0; t < threads.size(); t++)
+    threads[t].join();
+  require(shared.unique() && (*shared)[0] == 'x',
+    "CowPtrTest: shared string changed");
+  cout << "threads done, rc = "
+       << shared.useCount() << endl;
+} ///:~
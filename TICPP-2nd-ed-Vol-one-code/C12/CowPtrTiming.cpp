@@ -0,0 +1,93 @@
+//: C12:CowPtrTiming.cpp
+// Many holders of one large payload: copying
+// the holders, reading through them and writing
+// to a few. Deep copy (CopyingWithPointers.cpp),
+// shared_ptr<const> with a copy made by hand
+// before a write, and CowPtr.
+// Usage: CowPtrTiming [holders [payload [writeEvery]]]
+#include "CowPtr.h"
+#include "../Stopwatch.h"
+#include "../require.h"
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <vector>
+using namespace std;
+
+typedef vector<double> Payload;
+
+long sum = 0;
+
+// Each holder owns a copy:
+struct DeepHolder {
+  Payload p;
+  DeepHolder(const Payload& pp) : p(pp) {}
+  double read() const { return p[0]; }
+  void write(double d) { p[0] = d; }
+};
+
+struct SharedHolder {
+  shared_ptr<Payload> p;
+  SharedHolder(const Payload& pp)
+    : p(make_shared<Payload>(pp)) {}
+  double read() const {
+    const Payload& v = *p;
+    return v[0];
+  }
+  void write(double d) {
+    if(p.use_count() > 1)
+      p = make_shared<Payload>(*p);
+    (*p)[0] = d;
+  }
+};
+
+struct CowHolder {
+  CowPtr<Payload> p;
+  CowHolder(const Payload& pp) : p(pp) {}
+  double read() const { return (*p)[0]; }
+  void write(double d) { p.write()[0] = d; }
+};
+
+template<class Holder>
+double time(int holders, const Payload& payload,
+  int writeEvery) {
+  Stopwatch sw;
+  Holder original(payload);
+  vector<Holder> copies;
+  copies.reserve(holders);
+  for(int i = 0; i < holders; i++)
+    copies.push_back(original); // Copy-construct
+  for(int pass = 0; pass < 10; pass++)
+    for(int i = 0; i < holders; i++)
+      sum += long(copies[i].read());
+  for(int i = 0; i < holders; i += writeEvery)
+    copies[i].write(i);
+  for(int i = 1; i < holders; i++)
+    copies[i] = copies[i - 1]; // Assign
+  return sw.nanosPer(holders);
+}
+
+int main(int argc, char* argv[]) {
+  int holders = 100000, size = 1000;
+  int writeEvery = 100;
+  if(argc > 1) holders = atoi(argv[1]);
+  if(argc > 2) size = atoi(argv[2]);
+  if(argc > 3) writeEvery = atoi(argv[3]);
+  require(holders > 1 && size > 0 &&
+    writeEvery > 0, "CowPtrTiming: bad arguments");
+  Payload payload(size, 1.0);
+  cout << holders << " holders of " << size
+       << " doubles, 1 in " << writeEvery
+       << " written" << endl
+       << "ns per holder:" << endl;
+  cout << "deep copy\t"
+       << time<DeepHolder>(holders, payload,
+            writeEvery) << endl;
+  cout << "shared_ptr\t"
+       << time<SharedHolder>(holders, payload,
+            writeEvery) << endl;
+  cout << "CowPtr\t\t"
+       << time<CowHolder>(holders, payload,
+            writeEvery) << endl;
+  cout << "(" << sum << ")" << endl;
+} ///:~
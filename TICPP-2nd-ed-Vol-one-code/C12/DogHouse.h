@@ -0,0 +1,167 @@
+//: C12:DogHouse.h
+// ReferenceCounting.cpp's Dog and DogHouse, moved
+// to a header so timing programs can use them.
+// The trace of every call goes through TRACE
+// (see Trace.h) instead of straight to cout.
+// attach(n)/detach(n) move the count by n at
+// once, DogHouse::share() and release() use them
+// for whole vectors of houses, and the last
+// detach hands the Dog to the Reclaimer.
+#ifndef DOGHOUSE_H
+#define DOGHOUSE_H
+#include "../require.h"
+#include "../Trace.h"
+#include "Reclaimer.h"
+#include <string>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+class Dog {
+  std::string nm;
+  int refcount;
+  Dog(const std::string& name)
+    : nm(name), refcount(1) {
+    TRACE("Creating Dog: " << *this);
+  }
+  // Prevent assignment:
+  Dog& operator=(const Dog& rv);
+public:
+  // Dogs can only be created on the heap:
+  static Dog* make(const std::string& name) {
+    return new Dog(name);
+  }
+  Dog(const Dog& d)
+    : nm(d.nm + " copy"), refcount(1) {
+    TRACE("Dog copy-constructor: " << *this);
+  }
+  ~Dog() {
+    TRACE("Deleting Dog: " << *this);
+  }
+  void attach(int n = 1) {
+    refcount += n;
+    TRACE("Attached Dog: " << *this);
+  }
+  void detach(int n = 1) {
+    require(refcount >= n);
+    TRACE("Detaching Dog: " << *this);
+    // Destroy object if no one is using it:
+    if((refcount -= n) == 0)
+      Reclaimer::retire(this);
+  }
+  // Conditionally copy this Dog.
+  // Call before modifying the Dog, assign
+  // resulting pointer to your Dog*.
+  Dog* unalias() {
+    TRACE("Unaliasing Dog: " << *this);
+    // Don't duplicate if not aliased:
+    if(refcount == 1) return this;
+    --refcount;
+    // Use copy-constructor to duplicate:
+    return new Dog(*this);
+  }
+  void rename(const std::string& newName) {
+    nm = newName;
+    TRACE("Dog renamed to: " << *this);
+  }
+  friend std::ostream&
+  operator<<(std::ostream& os, const Dog& d) {
+    return os << "[" << d.nm << "], rc = "
+      << d.refcount;
+  }
+};
+
+class DogHouse {
+  Dog* p;
+  std::string houseName;
+  // Takes over a reference already attached:
+  DogHouse(const std::string& house, Dog* dog)
+    : p(dog), houseName(house) {}
+public:
+  DogHouse(Dog* dog, const std::string& house)
+   : p(dog), houseName(house) {
+    TRACE("Created DogHouse: "<< *this);
+  }
+  DogHouse(const DogHouse& dh)
+    : p(dh.p),
+      houseName("copy-constructed " +
+        dh.houseName) {
+    p->attach();
+    TRACE("DogHouse copy-constructor: " << *this);
+  }
+  // Moving a house leaves the count alone:
+  DogHouse(DogHouse&& dh) noexcept
+    : p(dh.p),
+      houseName(std::move(dh.houseName)) {
+    dh.p = 0;
+  }
+  DogHouse& operator=(const DogHouse& dh) {
+    // Check for self-assignment:
+    if(&dh != this) {
+      houseName = dh.houseName + " assigned";
+      // Clean up what you're using first:
+      if(p) p->detach();
+      p = dh.p; // Like copy-constructor
+      p->attach();
+    }
+    TRACE("DogHouse operator= : " << *this);
+    return *this;
+  }
+  // Decrement refcount, conditionally destroy
+  ~DogHouse() {
+    if(p == 0) return; // Moved from or released
+    TRACE("DogHouse destructor: " << *this);
+    p->detach();
+  }
+  // Append n copies of dh to v with a single
+  // attach(n):
+  static void share(const DogHouse& dh, int n,
+    std::vector<DogHouse>& v) {
+    require(n >= 0, "DogHouse::share negative n");
+    v.reserve(v.size() + n);
+    dh.p->attach(n);
+    const std::string name =
+      "copy-constructed " + dh.houseName;
+    for(int i = 0; i < n; i++)
+      v.push_back(DogHouse(name, dh.p));
+    TRACE("DogHouse::share " << n << ": " << dh);
+  }
+  // Empty v, with one detach(n) for each run of
+  // houses holding the same Dog:
+  static void release(std::vector<DogHouse>& v) {
+    std::size_t i = 0;
+    while(i < v.size()) {
+      Dog* dog = v[i].p;
+      std::size_t j = i;
+      while(j < v.size() && v[j].p == dog)
+        v[j++].p = 0;
+      if(dog) dog->detach(int(j - i));
+      i = j;
+    }
+    TRACE("DogHouse::release " << v.size());
+    v.clear();
+  }
+  void renameHouse(const std::string& newName) {
+    houseName = newName;
+  }
+  void unalias() { p = p->unalias(); }
+  // Copy-on-write. Anytime you modify the
+  // contents of the pointer you must
+  // first unalias it:
+  void renameDog(const std::string& newName) {
+    unalias();
+    p->rename(newName);
+  }
+  // ... or when you allow someone else access:
+  Dog* getDog() {
+    unalias();
+    return p;
+  }
+  friend std::ostream&
+  operator<<(std::ostream& os, const DogHouse& dh) {
+    os << "[" << dh.houseName << "] ";
+    if(dh.p == 0) return os << "is empty";
+    return os << "contains " << *dh.p;
+  }
+};
+#endif // DOGHOUSE_H ///:~
@@ -0,0 +1,67 @@
+//: C12:DogHouseTiming.cpp
+// The reference-counting path of DogHouse.h:
+// many DogHouses sharing one Dog are copied,
+// assigned, read through getDog() and destroyed.
+// TRACE is compiled out unless TRACE_LEVEL is
+// given; build with -DTRACE_LEVEL=1 (ring
+// buffer) or 2 (stream) to compare. Traced lines
+// go to DogHouseTiming.out.
+// Usage: DogHouseTiming [houses [passes]]
+#ifndef TRACE_LEVEL
+#define TRACE_LEVEL 0
+#endif
+#include "DogHouse.h"
+#include "../Stopwatch.h"
+#include "../require.h"
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <vector>
+using namespace std;
+
+ofstream out("DogHouseTiming.out");
+
+int main(int argc, char* argv[]) {
+  int houses = 100000, passes = 10;
+  if(argc > 1) houses = atoi(argv[1]);
+  if(argc > 2) passes = atoi(argv[2]);
+  require(houses > 1 && passes > 0,
+    "DogHouseTiming: bad arguments");
+  Trace::sink() = &out;
+  cout << "TRACE_LEVEL " << Trace::level << ", "
+       << houses << " houses, " << passes
+       << " passes" << endl
+       << "ns per house:" << endl;
+  double copy = 0, assign = 0, destroy = 0;
+  double get = 0;
+  long dogs = 0;
+  for(int pass = 0; pass < passes; pass++) {
+    DogHouse first(Dog::make("Fido"), "FidoHouse");
+    DogHouse other(Dog::make("Spot"), "SpotHouse");
+    vector<DogHouse>* v = new vector<DogHouse>;
+    v->reserve(houses);
+    Stopwatch sw;
+    for(int i = 0; i < houses; i++)
+      v->push_back(first); // attach()
+    copy += sw.nanosPer(houses);
+    sw.mark();
+    for(int i = 0; i < houses; i++)
+      (*v)[i] = other; // detach() + attach()
+    assign += sw.nanosPer(houses);
+    sw.mark();
+    // The last house holding Spot alone doesn't
+    // copy it; the rest unalias() once each:
+    for(int i = houses - 1; i >= houses - 100 &&
+      i >= 0; i--)
+      dogs += long((*v)[i].getDog() != 0);
+    get += sw.nanosPer(100);
+    sw.mark();
+    delete v; // detach(), the unaliased Dogs die
+    destroy += sw.nanosPer(houses);
+  }
+  cout << "copy\t" << copy / passes << endl
+       << "assign\t" << assign / passes << endl
+       << "getDog\t" << get / passes << endl
+       << "destroy\t" << destroy / passes << endl
+       << "(" << dogs << " dogs)" << endl;
+} ///:~
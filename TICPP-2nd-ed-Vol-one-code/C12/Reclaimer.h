@@ -0,0 +1,200 @@
+//: C12:Reclaimer.h
+// Deferred destruction for reference-counted
+// objects. The last detach() hands the object to
+// Reclaimer::retire() instead of deleting it in
+// place, so releasing a large graph doesn't stall
+// the caller. Three modes:
+//   immediate:  retire() deletes at once (the
+//               old behavior, and the default)
+//   deferred:   objects queue until drain()
+//               is called at a point of your
+//               choosing
+//   background: a reclaimer thread deletes them
+// Each thread collects retired objects in a
+// batch of its own and takes the lock once per
+// batchSize of them, or when it calls drain().
+// Objects retired in background mode must not
+// touch unsynchronized shared state in their
+// destructors. Link with -pthread.
+#ifndef RECLAIMER_H
+#define RECLAIMER_H
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class Reclaimer {
+public:
+  enum Mode { immediate, deferred, background };
+  enum { batchSize = 256 };
+private:
+  struct Retired {
+    void* p;
+    void (*destroy)(void*);
+  };
+  // The calling thread's batch, handed on when
+  // the thread exits:
+  struct Batch {
+    std::vector<Retired> v;
+    ~Batch() { instance().push(v); }
+  };
+  static std::vector<Retired>& batch() {
+    static thread_local Batch b;
+    return b.v;
+  }
+  std::mutex lock;
+  std::condition_variable wake, idle;
+  std::vector<Retired> queue;
+  // Read on any thread without the lock, and
+  // only changed between phases of a program:
+  std::atomic<Mode> md;
+  bool busy; // The thread is deleting a batch
+  bool quit;
+  std::size_t done;
+  std::thread worker;
+  Reclaimer() : md(immediate), busy(false),
+    quit(false), done(0) {}
+  ~Reclaimer() { // Nothing leaks at exit
+    mode(immediate);
+    drainQueue();
+  }
+  Reclaimer(const Reclaimer&);
+  void operator=(const Reclaimer&);
+  template<class T> static void destroy(void* p) {
+    delete static_cast<T*>(p);
+  }
+  // Delete a batch outside the lock:
+  std::size_t destroyAll(std::vector<Retired>& v) {
+    for(std::size_t i = 0; i < v.size(); i++)
+      v[i].destroy(v[i].p);
+    std::size_t n = v.size();
+    v.clear();
+    return n;
+  }
+  void run() {
+    std::vector<Retired> work;
+    // Destructors run here may retire more (an
+    // object releasing what it owns); those land
+    // in this thread's batch:
+    std::vector<Retired>& cascaded = batch();
+    std::unique_lock<std::mutex> l(lock);
+    for(;;) {
+      wake.wait(l, [this] {
+        return quit || !queue.empty();
+      });
+      if(queue.empty()) break; // quit
+      work.swap(queue);
+      busy = true;
+      l.unlock();
+      std::size_t n = destroyAll(work);
+      l.lock();
+      queue.insert(queue.end(), cascaded.begin(),
+        cascaded.end());
+      cascaded.clear();
+      busy = false;
+      done += n;
+      idle.notify_all();
+    }
+  }
+  // Move a thread's batch to the shared queue:
+  void push(std::vector<Retired>& v) {
+    if(v.empty()) return;
+    bool wasEmpty;
+    {
+      std::lock_guard<std::mutex> l(lock);
+      wasEmpty = queue.empty();
+      queue.insert(queue.end(), v.begin(), v.end());
+    }
+    v.clear();
+    // The thread only sleeps on an empty queue:
+    if(md.load(std::memory_order_relaxed) ==
+      background && wasEmpty)
+      wake.notify_one();
+  }
+  std::size_t drainQueue() {
+    std::unique_lock<std::mutex> l(lock);
+    if(md.load(std::memory_order_relaxed) ==
+      background) {
+      std::size_t before = done;
+      idle.wait(l, [this] {
+        return queue.empty() && !busy;
+      });
+      return done - before;
+    }
+    // Until deleting retires nothing more:
+    std::size_t n = 0;
+    std::vector<Retired> all;
+    while(!queue.empty()) {
+      all.swap(queue);
+      l.unlock();
+      n += destroyAll(all);
+      push(batch());
+      l.lock();
+    }
+    done += n;
+    return n;
+  }
+  void stopWorker() {
+    if(!worker.joinable()) return;
+    {
+      std::lock_guard<std::mutex> l(lock);
+      quit = true;
+    }
+    wake.notify_one();
+    worker.join();
+    quit = false;
+  }
+public:
+  static Reclaimer& instance() {
+    static Reclaimer r;
+    return r;
+  }
+  template<class T> static void retire(T* p) {
+    Reclaimer& r = instance();
+    if(r.md.load(std::memory_order_relaxed) ==
+      immediate) {
+      delete p;
+      return;
+    }
+    Retired rt = { p, &destroy<T> };
+    std::vector<Retired>& b = batch();
+    b.push_back(rt);
+    if(b.size() >= batchSize) r.push(b);
+  }
+  // Switching out of background mode stops the
+  // thread; whatever it left stays queued.
+  void mode(Mode m) {
+    Mode old = md.load(std::memory_order_relaxed);
+    if(m == old) return;
+    if(old == background) stopWorker();
+    md.store(m, std::memory_order_relaxed);
+    if(m == background)
+      worker = std::thread([this] { run(); });
+  }
+  Mode mode() const {
+    return md.load(std::memory_order_relaxed);
+  }
+  // Delete everything queued so far, including
+  // this thread's batch (other threads' batches
+  // wait until they fill or the threads drain or
+  // exit), on this thread; in background mode,
+  // wait for the reclaimer thread instead.
+  // Returns the number this call saw deleted.
+  std::size_t drain() {
+    push(batch());
+    return drainQueue();
+  }
+  // Queued, counting this thread's batch:
+  std::size_t pending() {
+    std::lock_guard<std::mutex> l(lock);
+    return queue.size() + batch().size();
+  }
+  // Total deleted from the queue:
+  std::size_t reclaimed() {
+    std::lock_guard<std::mutex> l(lock);
+    return done;
+  }
+};
+#endif // RECLAIMER_H ///:~
@@ -0,0 +1,101 @@
+//: C12:ReclaimerTest.cpp
+// Bulk attach/detach through DogHouse::share()
+// and release(), and the three Reclaimer modes.
+#ifndef TRACE_LEVEL
+#define TRACE_LEVEL 0
+#endif
+#include "DogHouse.h"
+#include "Reclaimer.h"
+#include "../require.h"
+#include <atomic>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+using namespace std;
+
+atomic<int> live(0);
+
+struct Bone {
+  Bone() { live++; }
+  ~Bone() { live--; }
+};
+
+// Releasing a graph: each link retires the next
+struct Chain {
+  Chain* next;
+  Chain(int n) : next(n > 1 ? new Chain(n - 1) : 0) {
+    live++;
+  }
+  ~Chain() {
+    live--;
+    if(next) Reclaimer::retire(next);
+  }
+};
+
+string show(const DogHouse& dh) {
+  ostringstream os;
+  os << dh;
+  return os.str();
+}
+
+int main() {
+  Reclaimer& r = Reclaimer::instance();
+  DogHouse fidos(Dog::make("Fido"), "FidoHouse");
+  vector<DogHouse> houses;
+  DogHouse::share(fidos, 1000, houses);
+  cout << show(houses[999]) << endl;
+  require(show(fidos).find("rc = 1001") !=
+    string::npos, "share: one attach(1000)");
+  DogHouse::release(houses);
+  require(houses.empty() &&
+    show(fidos).find("rc = 1") != string::npos,
+    "release: one detach(1000)");
+  cout << show(fidos) << endl;
+
+  // The last detach queues the Dog:
+  r.mode(Reclaimer::deferred);
+  {
+    DogHouse spots(Dog::make("Spot"), "SpotHouse");
+    DogHouse::share(spots, 10, houses);
+    DogHouse::release(houses);
+  }
+  require(r.pending() == 1, "deferred: Dog queued");
+  require(r.drain() == 1, "deferred: drain");
+  for(int i = 0; i < 100; i++)
+    Reclaimer::retire(new Bone);
+  require(live == 100 && r.pending() == 100,
+    "deferred: nothing deleted before drain()");
+  r.drain();
+  require(live == 0, "deferred: drain() deletes");
+  Reclaimer::retire(new Chain(3));
+  r.drain();
+  require(live == 0 && r.pending() == 0,
+    "deferred: drain() deletes what it retires");
+  cout << "deferred: " << r.reclaimed()
+       << " reclaimed" << endl;
+
+  r.mode(Reclaimer::background);
+  for(int i = 0; i < 100000; i++)
+    Reclaimer::retire(new Bone);
+  r.drain(); // Waits for the thread
+  require(live == 0 && r.pending() == 0,
+    "background: all deleted");
+  Reclaimer::retire(new Chain(3));
+  r.drain();
+  require(live == 0 && r.pending() == 0,
+    "background: drain() deletes what it retires");
+  cout << "background: " << r.reclaimed()
+       << " reclaimed" << endl;
+  // Leaving background mode stops the thread:
+  for(int i = 0; i < 1000; i++)
+    Reclaimer::retire(new Bone);
+  r.mode(Reclaimer::immediate);
+  r.drain();
+  require(live == 0, "mode change loses nothing");
+  Reclaimer::retire(new Bone);
+  require(live == 0 && r.pending() == 0,
+    "immediate: deleted at once");
+  cout << "immediate: " << r.reclaimed()
+       << " reclaimed" << endl;
+} ///:~
@@ -0,0 +1,99 @@
+//: C12:ReleaseTiming.cpp
+// First: houses sharing one Dog, copied and
+// destroyed one at a time, then through
+// DogHouse::share() and release(). Second:
+// kennels of houses, each holding its own Dog
+// with a long name, released one kennel at a
+// time; the mean and worst release in each
+// Reclaimer mode show how much of the freeing
+// the caller still pays for.
+// Usage: ReleaseTiming [houses [kennels [dogs [nameSize]]]]
+#ifndef TRACE_LEVEL
+#define TRACE_LEVEL 0
+#endif
+#include "DogHouse.h"
+#include "Reclaimer.h"
+#include "../Stopwatch.h"
+#include "../require.h"
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+void shared(int houses) {
+  DogHouse fidos(Dog::make("Fido"), "FidoHouse");
+  vector<DogHouse> v;
+  v.reserve(houses);
+  Stopwatch sw;
+  for(int i = 0; i < houses; i++)
+    v.push_back(fidos); // attach()
+  double copy = sw.nanosPer(houses);
+  sw.mark();
+  v.clear(); // detach() each
+  double destroy = sw.nanosPer(houses);
+  sw.mark();
+  DogHouse::share(fidos, houses, v);
+  double share = sw.nanosPer(houses);
+  sw.mark();
+  DogHouse::release(v);
+  double release = sw.nanosPer(houses);
+  cout << houses << " houses sharing one Dog,"
+       << " ns per house:" << endl
+       << "copy\t" << copy << "\tshare\t"
+       << share << endl
+       << "destroy\t" << destroy << "\trelease\t"
+       << release << endl;
+}
+
+void kennels(const char* label, int kennels,
+  int dogs, const string& name) {
+  vector<vector<DogHouse> > all(kennels);
+  for(int k = 0; k < kennels; k++) {
+    all[k].reserve(dogs);
+    for(int d = 0; d < dogs; d++)
+      all[k].push_back(
+        DogHouse(Dog::make(name), "House"));
+  }
+  double total = 0, worst = 0;
+  Stopwatch overall;
+  for(int k = 0; k < kennels; k++) {
+    Stopwatch sw;
+    DogHouse::release(all[k]);
+    double us = sw.seconds() * 1e6;
+    total += us;
+    if(us > worst) worst = us;
+  }
+  Stopwatch sw;
+  Reclaimer::instance().drain();
+  double drain = sw.seconds() * 1e3;
+  cout << label << "\t" << total / kennels
+       << "\t" << worst << "\t" << drain
+       << "\t" << overall.seconds() * 1e3 << endl;
+}
+
+int main(int argc, char* argv[]) {
+  // Names past malloc's mmap threshold make
+  // each Dog expensive to free:
+  int houses = 1000000, nKennels = 50;
+  int dogs = 100, nameSize = 200000;
+  if(argc > 1) houses = atoi(argv[1]);
+  if(argc > 2) nKennels = atoi(argv[2]);
+  if(argc > 3) dogs = atoi(argv[3]);
+  if(argc > 4) nameSize = atoi(argv[4]);
+  require(houses > 0 && nKennels > 0 && dogs > 0
+    && nameSize >= 0, "ReleaseTiming: bad arguments");
+  shared(houses);
+  string name(nameSize, 'x');
+  cout << nKennels << " kennels of " << dogs
+       << " Dogs, " << nameSize << "-byte names"
+       << endl << "mode\t\trelease us\tworst us"
+       << "\tdrain ms\ttotal ms" << endl;
+  Reclaimer& r = Reclaimer::instance();
+  kennels("immediate", nKennels, dogs, name);
+  r.mode(Reclaimer::deferred);
+  kennels("deferred", nKennels, dogs, name);
+  r.mode(Reclaimer::background);
+  kennels("background", nKennels, dogs, name);
+  r.mode(Reclaimer::immediate);
+} ///:~
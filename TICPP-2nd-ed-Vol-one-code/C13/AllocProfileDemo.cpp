@@ -0,0 +1,79 @@
+//: C13:AllocProfileDemo.cpp
+//{L} AllocProfiler PStash
+// Where does the churn come from? PStash pointer
+// arrays, the strings they hold and a Link-based
+// stack, seen through AllocProfiler, plus the
+// profiler's own cost per new+delete.
+// Usage: AllocProfileDemo [rounds]
+#include "AllocProfiler.h"
+#include "PStash.h"
+#include "../Stopwatch.h"
+#include "../require.h"
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+using namespace std;
+
+struct Link {
+  string* data;
+  Link* next;
+  Link(string* d, Link* n) : data(d), next(n) {}
+};
+
+void churn(int rounds) {
+  for(int r = 0; r < rounds; r++) {
+    PStash words;
+    Link* head = 0;
+    for(int i = 0; i < 100; i++) {
+      string* s = new string(20 + i % 40, 'x');
+      words.add(s);
+      head = new Link(s, head);
+    }
+    while(head) {
+      Link* next = head->next;
+      delete head;
+      head = next;
+    }
+    for(int i = 0; i < words.count(); i++)
+      delete (string*)words.remove(i);
+  }
+}
+
+double nanosPerPair(long n) {
+  Stopwatch sw;
+  for(long i = 0; i < n; i++) {
+    int* volatile p = new int(i);
+    delete p;
+  }
+  return sw.nanosPer(n);
+}
+
+int main(int argc, char* argv[]) {
+  int rounds = 1000;
+  if(argc > 1) rounds = atoi(argv[1]);
+  long before = AllocProfiler::liveBytes();
+  churn(rounds);
+  // require()'s message is a string too; read
+  // the count before it exists:
+  bool balanced =
+    AllocProfiler::liveBytes() == before;
+  require(balanced, "AllocProfileDemo: bytes leaked");
+  require(AllocProfiler::allocations() >=
+    long(rounds) * 300,
+    "AllocProfileDemo: allocations not counted");
+  // Same report as at exit:
+  raise(SIGUSR1);
+  const long n = 5000000;
+  AllocProfiler::setSampleRate(0);
+  double counted = nanosPerPair(n);
+  AllocProfiler::enable(false);
+  double off = nanosPerPair(n);
+  AllocProfiler::enable(true);
+  AllocProfiler::setSampleRate(1024);
+  double sampled = nanosPerPair(n);
+  cout << "ns per new+delete: not counted " << off
+       << ", counted " << counted
+       << ", counted and sampled " << sampled
+       << endl;
+} ///:~
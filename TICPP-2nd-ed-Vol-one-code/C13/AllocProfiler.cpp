@@ -0,0 +1,381 @@
+//: C13:AllocProfiler.cpp {O}
+// Replacement global new/delete that feeds
+// AllocProfiler's counters. Every block carries
+// a 16-byte header holding its size, so delete
+// can find the size class without asking malloc.
+// The size-class counters belong to one thread
+// each and are bumped with plain loads and
+// stores; only the live byte total is a shared
+// read-modify-write.
+#include "AllocProfiler.h"
+#include <atomic>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <execinfo.h>
+#include <new>
+#include <unistd.h>
+using namespace std;
+
+namespace {
+
+struct Header {
+  size_t size;
+  size_t pad; // Keeps the block 16-byte aligned
+};
+
+// One per thread; a new thread takes over the
+// record of one that has exited, so the totals
+// keep adding up:
+struct Counters {
+  atomic<long> allocs[AllocProfiler::sizeClasses];
+  atomic<long> frees[AllocProfiler::sizeClasses];
+  atomic<long> bytes[AllocProfiler::sizeClasses];
+  atomic<long> freed[AllocProfiler::sizeClasses];
+  atomic<bool> claimed;
+  Counters* next;
+};
+
+struct Site {
+  atomic<unsigned long> hash; // 0 while unused
+  void* frames[AllocProfiler::stackDepth];
+  int depth;
+  atomic<long> count, bytes;
+};
+
+// Zero-initialized before any constructor runs,
+// so allocations during static initialization
+// are counted safely:
+Site sites[AllocProfiler::maxSites];
+atomic<Counters*> records;
+// For threads past their thread_local
+// destructors; shared, so updated atomically:
+Counters late;
+atomic<long> liveTotal, peakTotal;
+atomic<long> droppedSamples;
+atomic<int> sampleRate;
+atomic<bool> disabled;
+atomic_flag siteLock = ATOMIC_FLAG_INIT;
+thread_local int countdown;
+thread_local bool inProfiler; // backtrace() allocates
+thread_local Counters* mine;
+
+struct Release {
+  ~Release() {
+    mine->claimed.store(false);
+    mine = &late;
+  }
+};
+
+Counters& counters() {
+  if(mine) return *mine;
+  for(Counters* c = records.load(); c; c = c->next) {
+    bool free = false;
+    if(c->claimed.compare_exchange_strong(free,
+      true)) {
+      mine = c;
+      break;
+    }
+  }
+  if(!mine) { // calloc: zeroed, and not new
+    Counters* c =
+      (Counters*)calloc(1, sizeof(Counters));
+    if(!c) return late;
+    c->claimed.store(true);
+    c->next = records.load();
+    while(!records.compare_exchange_weak(c->next, c))
+      ;
+    mine = c;
+  }
+  static thread_local Release release;
+  (void)&release; // Constructs it
+  return *mine;
+}
+
+inline void bump(Counters& c, atomic<long>& n,
+  long by) {
+  if(&c == &late)
+    n.fetch_add(by, memory_order_relaxed);
+  else // Only this thread writes n
+    n.store(n.load(memory_order_relaxed) + by,
+      memory_order_relaxed);
+}
+
+typedef atomic<long>
+  PerClass[AllocProfiler::sizeClasses];
+
+inline long sum(PerClass Counters::*field,
+  int sizeClass) {
+  long total = (late.*field)[sizeClass].load();
+  for(Counters* c = records.load(); c; c = c->next)
+    total += (c->*field)[sizeClass].load();
+  return total;
+}
+
+inline int sizeClass(size_t sz) {
+  if(sz <= 16) return 0;
+  int c = 64 - __builtin_clzl(sz - 1) - 4;
+  return c < AllocProfiler::sizeClasses ?
+    c : AllocProfiler::sizeClasses - 1;
+}
+
+// noinline keeps the two frames to skip exact:
+__attribute__((noinline)) void sample(size_t sz) {
+  inProfiler = true;
+  void* frames[AllocProfiler::stackDepth + 2];
+  // Skip sample() and allocate():
+  int n = backtrace(frames,
+    AllocProfiler::stackDepth + 2) - 2;
+  if(n < 1) {
+    inProfiler = false;
+    return;
+  }
+  unsigned long h = 14695981039346656037UL;
+  for(int i = 0; i < n; i++)
+    h = (h ^ (unsigned long)frames[i + 2]) *
+      1099511628211UL;
+  if(h == 0) h = 1;
+  while(siteLock.test_and_set(memory_order_acquire))
+    ;
+  int slot = h % AllocProfiler::maxSites;
+  int probes = 0;
+  while(sites[slot].hash.load() != 0 &&
+    sites[slot].hash.load() != h &&
+    ++probes < AllocProfiler::maxSites)
+    slot = (slot + 1) % AllocProfiler::maxSites;
+  if(probes == AllocProfiler::maxSites)
+    droppedSamples++;
+  else {
+    Site& s = sites[slot];
+    if(s.hash.load() == 0) {
+      memcpy(s.frames, frames + 2, n * sizeof(void*));
+      s.depth = n;
+      s.hash.store(h);
+    }
+    s.count++;
+    s.bytes += sz;
+  }
+  siteLock.clear(memory_order_release);
+  inProfiler = false;
+}
+
+__attribute__((noinline)) void* allocate(size_t sz) {
+  Header* h;
+  // As the standard operator new does: let the
+  // new_handler free memory and try again.
+  while(!(h = (Header*)malloc(sizeof(Header) + sz))) {
+    new_handler handler = get_new_handler();
+    if(!handler) throw bad_alloc();
+    handler();
+  }
+  h->size = sz;
+  h->pad = 0;
+  if(!disabled.load(memory_order_relaxed) &&
+    !inProfiler) {
+    Counters& c = counters();
+    int i = sizeClass(sz);
+    bump(c, c.allocs[i], 1);
+    bump(c, c.bytes[i], sz);
+    long live = liveTotal.fetch_add(sz,
+      memory_order_relaxed) + sz;
+    long peak = peakTotal.load(memory_order_relaxed);
+    while(live > peak &&
+      !peakTotal.compare_exchange_weak(peak, live,
+        memory_order_relaxed))
+      ;
+    int rate = sampleRate.load(memory_order_relaxed);
+    if(rate > 0 && --countdown <= 0) {
+      countdown = rate;
+      sample(sz);
+    }
+  } else
+    h->pad = 1; // Not counted, don't uncount it
+  return h + 1;
+}
+
+void release(void* m) {
+  if(!m) return;
+  Header* h = (Header*)m - 1;
+  if(h->pad == 0) {
+    Counters& c = counters();
+    int i = sizeClass(h->size);
+    bump(c, c.frees[i], 1);
+    bump(c, c.freed[i], h->size);
+    liveTotal.fetch_sub(h->size, memory_order_relaxed);
+  }
+  free(h);
+}
+
+// No malloc from here on: dump() may run in a
+// signal handler or while the heap is torn down.
+// Neither is snprintf() safe in a handler, so a
+// Line does its own number formatting.
+class Line {
+  enum { size = 160 };
+  char text[size];
+  int n;
+public:
+  Line() : n(0) {}
+  Line& operator<<(const char* s) {
+    while(*s && n < size) text[n++] = *s++;
+    return *this;
+  }
+  // v right-aligned in width characters:
+  Line& number(long v, int width = 0) {
+    char digits[24];
+    int d = 0;
+    unsigned long u = v < 0 ?
+      0UL - (unsigned long)v : (unsigned long)v;
+    do {
+      digits[d++] = char('0' + u % 10);
+      u /= 10;
+    } while(u > 0);
+    if(v < 0) digits[d++] = '-';
+    for(int pad = width - d; pad > 0 && n < size;
+      pad--)
+      text[n++] = ' ';
+    while(d > 0 && n < size) text[n++] = digits[--d];
+    return *this;
+  }
+  void send(int fd) const {
+    ssize_t written = write(fd, text, n);
+    (void)written; // Nowhere to report failure
+  }
+};
+
+void onSignal(int) { AllocProfiler::dump(2); }
+
+struct Startup {
+  Startup() {
+    const char* rate = getenv("ALLOCPROF_SAMPLE");
+    AllocProfiler::setSampleRate(
+      rate ? atoi(rate) : 1024);
+    AllocProfiler::dumpOnSignal(SIGUSR1);
+  }
+  ~Startup() {
+    const char* quiet = getenv("ALLOCPROF_QUIET");
+    if(!quiet || *quiet == '0')
+      AllocProfiler::dump(2);
+  }
+} startup;
+
+} // namespace
+
+void AllocProfiler::setSampleRate(int everyN) {
+  sampleRate.store(everyN < 0 ? 0 : everyN);
+}
+
+void AllocProfiler::enable(bool on) {
+  disabled.store(!on);
+}
+
+long AllocProfiler::liveBytes() {
+  return liveTotal.load();
+}
+
+long AllocProfiler::peakBytes() {
+  return peakTotal.load();
+}
+
+long AllocProfiler::allocations() {
+  long total = 0;
+  for(int i = 0; i < sizeClasses; i++)
+    total += sum(&Counters::allocs, i);
+  return total;
+}
+
+unsigned long AllocProfiler::classLimit(int c) {
+  return 16UL << c;
+}
+
+void AllocProfiler::dump(int fd) {
+  Line header;
+  header << "== AllocProfiler: ";
+  header.number(allocations()) << " allocations, ";
+  header.number(liveTotal.load()) << " bytes live, ";
+  header.number(peakTotal.load()) << " bytes peak\n";
+  header.send(fd);
+  (Line() << "  size <=       allocs        frees"
+    "          bytes         live\n").send(fd);
+  for(int i = 0; i < sizeClasses; i++) {
+    long allocs = sum(&Counters::allocs, i);
+    if(allocs == 0) continue;
+    long bytes = sum(&Counters::bytes, i);
+    Line row;
+    if(i < sizeClasses - 1)
+      row.number(classLimit(i), 10);
+    else
+      (row << ">").number(classLimit(i - 1), 9);
+    (row << " ").number(allocs, 12) << " ";
+    row.number(sum(&Counters::frees, i), 12) << " ";
+    row.number(bytes, 14) << " ";
+    row.number(bytes - sum(&Counters::freed, i), 12)
+      << "\n";
+    row.send(fd);
+  }
+  int rate = sampleRate.load();
+  if(rate == 0) return;
+  Line sampled;
+  sampled << "== Sampled stacks (1 in ";
+  sampled.number(rate) << " allocations, ";
+  sampled.number(droppedSamples.load())
+    << " dropped):\n";
+  sampled.send(fd);
+  for(int i = 0; i < maxSites; i++) {
+    Site& s = sites[i];
+    if(s.hash.load() == 0) continue;
+    Line site;
+    site << "-- ";
+    site.number(s.count.load()) << " samples, ";
+    site.number(s.bytes.load()) << " bytes\n";
+    site.send(fd);
+    backtrace_symbols_fd(s.frames, s.depth, fd);
+  }
+}
+
+void AllocProfiler::dumpOnSignal(int sig) {
+  signal(sig, onSignal);
+}
+
+void* operator new(size_t sz) {
+  return allocate(sz);
+}
+
+void* operator new[](size_t sz) {
+  return allocate(sz);
+}
+
+void* operator new(size_t sz,
+  const nothrow_t&) noexcept {
+  try {
+    return allocate(sz);
+  } catch(bad_alloc&) {
+    return 0;
+  }
+}
+
+void* operator new[](size_t sz,
+  const nothrow_t&) noexcept {
+  try {
+    return allocate(sz);
+  } catch(bad_alloc&) {
+    return 0;
+  }
+}
+
+void operator delete(void* m) noexcept {
+  release(m);
+}
+
+void operator delete[](void* m) noexcept {
+  release(m);
+}
+
+void operator delete(void* m, size_t) noexcept {
+  release(m);
+}
+
+void operator delete[](void* m, size_t) noexcept {
+  release(m);
+}
+///:~
@@ -0,0 +1,37 @@
+//: C13:AllocProfiler.h
+// Allocation profiler. Linking AllocProfiler.o
+// replaces the global operator new and delete
+// (GlobalOperatorNew.cpp's technique without the
+// printf on every call). Each block is counted
+// in a power-of-two size class with relaxed
+// atomics, live and peak bytes are tracked, and
+// one allocation in sampleRate records its call
+// stack. The report goes to stderr at exit and
+// whenever the process gets SIGUSR1.
+// Environment: ALLOCPROF_SAMPLE=N sets the rate
+// (0 turns sampling off), ALLOCPROF_QUIET=1 skips
+// the report at exit.
+#ifndef ALLOCPROFILER_H
+#define ALLOCPROFILER_H
+
+class AllocProfiler {
+public:
+  enum {
+    sizeClasses = 18, // 16 bytes to 1 MB and up
+    stackDepth = 12,
+    maxSites = 256    // Distinct sampled stacks
+  };
+  static void setSampleRate(int everyN);
+  // Count allocations at all; off costs a branch:
+  static void enable(bool on);
+  static long liveBytes();
+  static long peakBytes();
+  static long allocations();
+  static void dump(int fd = 2);
+  static void dumpOnSignal(int sig);
+  // Largest block size counted in class c; the
+  // last class takes everything bigger than the
+  // one before it:
+  static unsigned long classLimit(int c);
+};
+#endif // ALLOCPROFILER_H ///:~
@@ -0,0 +1,74 @@
+//: C13:ArenaTest.cpp
+// Placement new without the bookkeeping: Arena
+// constructs the objects and reset() calls the
+// destructors
+#include "../Arena.h"
+#include "../require.h"
+#include <cstdint>
+#include <iostream>
+#include <string>
+using namespace std;
+
+class X {
+  int i;
+public:
+  X(int ii = 0) : i(ii) {
+    cout << "X(" << i << ") ";
+  }
+  ~X() { cout << "~X(" << i << ") "; }
+};
+
+struct alignas(64) Line {
+  char bytes[64];
+};
+
+// Its own operator new hides the placement
+// form from new(p) Counted:
+struct Counted {
+  static int made;
+  void* operator new(size_t sz) {
+    made++;
+    return ::operator new(sz);
+  }
+  void operator delete(void* p) {
+    ::operator delete(p);
+  }
+};
+int Counted::made = 0;
+
+int main() {
+  Arena arena(1024);
+  for(int i = 0; i < 5; i++)
+    arena.make<X>(i);
+  cout << endl;
+  string* s = arena.make<string>(200, 'a');
+  require(s->size() == 200, "ArenaTest: string");
+  Line* line = arena.make<Line>();
+  require(uintptr_t(line) % 64 == 0,
+    "ArenaTest: Line misaligned");
+  arena.make<Counted>();
+  require(Counted::made == 0,
+    "ArenaTest: Counted::operator new used");
+  int* ints = (int*)arena.allocate(1000 * sizeof(int));
+  for(int i = 0; i < 1000; i++)
+    ints[i] = i; // Bigger than a chunk
+  int chunks = arena.chunks();
+  require(chunks >= 2, "ArenaTest: no new chunk");
+  arena.reset(); // Newest first
+  cout << endl;
+  X* again = arena.make<X>(47);
+  cout << endl;
+  require(arena.chunks() == chunks,
+    "ArenaTest: reset freed chunks");
+  for(int round = 0; round < 100; round++) {
+    arena.reset();
+    for(int i = 0; i < 100; i++)
+      arena.make<double>(i);
+  }
+  require(arena.chunks() == chunks,
+    "ArenaTest: chunks not reused");
+  (void)again;
+  arena.reset();
+  cout << "Arena holds " << chunks << " chunks"
+       << endl;
+} ///:~
@@ -0,0 +1,87 @@
+//: C13:ArenaTiming.cpp
+// One "request" makes a batch of short-lived
+// objects and drops them all: per-object new and
+// delete against an Arena and reset(). Word is
+// trivially destructible, Shape-like Node has a
+// virtual destructor that must run.
+// Usage: ArenaTiming [objects [perRequest]]
+#include "../Arena.h"
+#include "../Stopwatch.h"
+#include "../require.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+using namespace std;
+
+struct Word {
+  char text[24];
+  int length;
+  Word(const char* s) : length(strlen(s)) {
+    memcpy(text, s, length + 1);
+  }
+};
+
+long destroyed = 0;
+
+class Node {
+  int id;
+public:
+  Node(int i) : id(i) {}
+  virtual ~Node() { destroyed++; }
+  virtual int value() const { return id; }
+};
+
+long checksum = 0;
+
+template<class T, class Arg>
+double heap(long objects, int perRequest, Arg arg) {
+  vector<T*> live(perRequest);
+  Stopwatch sw;
+  for(long done = 0; done < objects;
+    done += perRequest) {
+    for(int i = 0; i < perRequest; i++)
+      live[i] = new T(arg);
+    checksum += sizeof(*live[perRequest - 1]);
+    for(int i = 0; i < perRequest; i++)
+      delete live[i];
+  }
+  return sw.nanosPer(objects);
+}
+
+template<class T, class Arg>
+double arena(long objects, int perRequest, Arg arg) {
+  Arena a;
+  Stopwatch sw;
+  for(long done = 0; done < objects;
+    done += perRequest) {
+    T* last = 0;
+    for(int i = 0; i < perRequest; i++)
+      last = a.make<T>(arg);
+    checksum += sizeof(*last);
+    a.reset();
+  }
+  return sw.nanosPer(objects);
+}
+
+int main(int argc, char* argv[]) {
+  long objects = 10000000;
+  int perRequest = 1000;
+  if(argc > 1) objects = atol(argv[1]);
+  if(argc > 2) perRequest = atoi(argv[2]);
+  require(objects > 0 && perRequest > 0,
+    "ArenaTiming: bad arguments");
+  cout << "ns per object\tnew/delete\tArena" << endl;
+  cout << "Word\t\t" << heap<Word>(objects,
+    perRequest, "request") << "\t\t"
+    << arena<Word>(objects, perRequest, "request")
+    << endl;
+  cout << "Node\t\t" << heap<Node>(objects,
+    perRequest, 47) << "\t\t"
+    << arena<Node>(objects, perRequest, 47)
+    << endl;
+  require(destroyed == 2 * ((objects + perRequest
+    - 1) / perRequest) * perRequest,
+    "ArenaTiming: destructors skipped");
+  cout << "(" << checksum << ")" << endl;
+} ///:~
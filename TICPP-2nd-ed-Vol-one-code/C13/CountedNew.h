@@ -0,0 +1,130 @@
+//: C13:CountedNew.h
+// ArrayOperatorNew's Widget, generalized: a class
+// that derives from CountedNew<itself> gets an
+// operator new, new[], delete and delete[] that
+// keep its live and peak bytes in atomic
+// counters. Every counted class is listed in a
+// registry that can be printed at any time.
+#ifndef COUNTEDNEW_H
+#define COUNTEDNEW_H
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <cxxabi.h>
+#include <iomanip>
+#include <new>
+#include <ostream>
+#include <string>
+#include <typeinfo>
+
+class Footprint {
+  std::string name;
+  std::atomic<long> liveBytes, peakBytes;
+  std::atomic<long> objects, arrays;
+  Footprint* next;
+  // The registry: a list that only grows
+  static std::atomic<Footprint*>& head() {
+    static std::atomic<Footprint*> h(0);
+    return h;
+  }
+  Footprint(const Footprint&);
+  void operator=(const Footprint&);
+public:
+  Footprint(const std::string& nm) : name(nm),
+    liveBytes(0), peakBytes(0), objects(0),
+    arrays(0), next(head().load()) {
+    while(!head().compare_exchange_weak(next, this))
+      ;
+  }
+  void allocated(std::size_t sz, bool array) {
+    (array ? arrays : objects).fetch_add(1,
+      std::memory_order_relaxed);
+    long live = liveBytes.fetch_add(sz,
+      std::memory_order_relaxed) + sz;
+    long peak = peakBytes.load(
+      std::memory_order_relaxed);
+    while(live > peak &&
+      !peakBytes.compare_exchange_weak(peak, live,
+        std::memory_order_relaxed))
+      ;
+  }
+  void freed(std::size_t sz) {
+    liveBytes.fetch_sub(sz,
+      std::memory_order_relaxed);
+  }
+  const std::string& className() const {
+    return name;
+  }
+  long live() const { return liveBytes.load(); }
+  long peak() const { return peakBytes.load(); }
+  // Calls to new and to new[]:
+  long news() const { return objects.load(); }
+  long arrayNews() const { return arrays.load(); }
+  static const Footprint* first() {
+    return head().load();
+  }
+  const Footprint* following() const {
+    return next;
+  }
+  static void report(std::ostream& os) {
+    os << std::left << std::setw(20) << "class"
+       << std::right << std::setw(12) << "live"
+       << std::setw(12) << "peak"
+       << std::setw(10) << "new"
+       << std::setw(10) << "new[]" << std::endl;
+    for(const Footprint* f = first(); f;
+      f = f->following())
+      os << std::left << std::setw(20)
+         << f->className() << std::right
+         << std::setw(12) << f->live()
+         << std::setw(12) << f->peak()
+         << std::setw(10) << f->news()
+         << std::setw(10) << f->arrayNews()
+         << std::endl;
+  }
+};
+
+// class Widget : public CountedNew<Widget> ...
+// A derived class is counted with its base.
+template<class T>
+class CountedNew {
+  static std::string demangled() {
+    int status = 0;
+    char* nm = abi::__cxa_demangle(
+      typeid(T).name(), 0, 0, &status);
+    std::string result(status == 0 ? nm :
+      typeid(T).name());
+    std::free(nm);
+    return result;
+  }
+public:
+  static Footprint& footprint() {
+    static Footprint f(demangled());
+    return f;
+  }
+  static void* operator new(std::size_t sz) {
+    void* m = ::operator new(sz);
+    footprint().allocated(sz, false);
+    return m;
+  }
+  static void* operator new[](std::size_t sz) {
+    void* m = ::operator new(sz);
+    footprint().allocated(sz, true);
+    return m;
+  }
+  // The sized forms also make new[] store the
+  // array size, so delete[] gets the same sz:
+  static void operator delete(void* p,
+    std::size_t sz) {
+    if(!p) return;
+    footprint().freed(sz);
+    ::operator delete(p);
+  }
+  static void operator delete[](void* p,
+    std::size_t sz) {
+    if(!p) return;
+    footprint().freed(sz);
+    ::operator delete(p);
+  }
+};
+#endif // COUNTEDNEW_H ///:~
@@ -0,0 +1,54 @@
+//: C13:CountedNewTest.cpp
+// Per-class footprints from CountedNew, with
+// objects and arrays made and freed on several
+// threads
+#include "CountedNew.h"
+#include "../require.h"
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace std;
+
+class Widget : public CountedNew<Widget> {
+  enum { sz = 10 };
+  int i[sz];
+};
+
+class Word : public CountedNew<Word> {
+  string text; // Its own buffer isn't counted
+public:
+  Word(const string& s = "") : text(s) {}
+};
+
+int main() {
+  Widget* w = new Widget;
+  Widget* wa = new Widget[25];
+  require(Widget::footprint().live() >=
+    long(26 * sizeof(Widget)),
+    "CountedNewTest: Widget bytes not counted");
+  vector<thread> threads;
+  for(int t = 0; t < 4; t++)
+    threads.push_back(thread([] {
+      for(int i = 0; i < 10000; i++) {
+        Word* words = new Word[i % 8 + 1];
+        delete new Word("transient");
+        delete []words;
+      }
+    }));
+  for(size_t t = 0; t < threads.size(); t++)
+    threads[t].join();
+  Footprint::report(cout);
+  require(Word::footprint().live() == 0,
+    "CountedNewTest: Word bytes leaked");
+  require(Word::footprint().peak() > 0 &&
+    Word::footprint().news() == 40000 &&
+    Word::footprint().arrayNews() == 40000,
+    "CountedNewTest: Word counts");
+  delete w;
+  delete []wa;
+  require(Widget::footprint().live() == 0,
+    "CountedNewTest: Widget bytes leaked");
+  cout << "after delete:" << endl;
+  Footprint::report(cout);
+} ///:~
@@ -0,0 +1,141 @@
+//: C13:FixedPool.h
+// Framis's block pool, made reusable.
+// FixedPool<T, N> hands out sizeof(T) blocks from
+// slabs of N. Free blocks are linked through
+// their own storage, so allocate() and
+// deallocate() are O(1) instead of a scan of
+// alloc_map[], and a full pool chains another
+// slab rather than throwing. With checked = true
+// every slab also keeps a bitmap of the blocks in
+// use, so a double delete or a pointer from
+// somewhere else is reported. PoolAllocated<T>
+// gives any class T new and delete from its own
+// FixedPool.
+#ifndef FIXEDPOOL_H
+#define FIXEDPOOL_H
+#include "../require.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+template<class T, int N = 100, bool checked = false>
+class FixedPool {
+  union Block {
+    Block* next; // While on the freelist
+    alignas(T) unsigned char bytes[sizeof(T)];
+  };
+  struct Slab {
+    Slab* next;
+    unsigned char map[(N + 7) / 8]; // checked only
+    Block blocks[N];
+  };
+  Slab* slabs;
+  Block* freeList;
+  int live;
+  int slabCount;
+  void addSlab() {
+    Slab* s = new Slab;
+    s->next = slabs;
+    slabs = s;
+    slabCount++;
+    if(checked)
+      std::memset(s->map, 0, sizeof s->map);
+    // Lowest address first off the freelist:
+    for(int i = N - 1; i >= 0; i--) {
+      s->blocks[i].next = freeList;
+      freeList = &s->blocks[i];
+    }
+  }
+  // The slab holding p and p's block number in it:
+  Slab* find(void* p, int& index) const {
+    std::uintptr_t a = std::uintptr_t(p);
+    for(Slab* s = slabs; s; s = s->next) {
+      std::uintptr_t b = std::uintptr_t(s->blocks);
+      if(a >= b && a < b + sizeof s->blocks) {
+        if((a - b) % sizeof(Block) != 0)
+          return 0; // Inside a block
+        index = int((a - b) / sizeof(Block));
+        return s;
+      }
+    }
+    return 0;
+  }
+  void mark(void* p, bool used) {
+    int i = 0;
+    Slab* s = find(p, i);
+    require(s != 0,
+      "FixedPool: pointer not from this pool");
+    unsigned char bit = 1 << (i % 8);
+    require(bool(s->map[i / 8] & bit) != used,
+      used ? "FixedPool: block handed out twice"
+        : "FixedPool: block freed twice");
+    s->map[i / 8] ^= bit;
+  }
+  FixedPool(const FixedPool&);
+  void operator=(const FixedPool&);
+public:
+  FixedPool() : slabs(0), freeList(0), live(0),
+    slabCount(0) {}
+  ~FixedPool() {
+    live = 0;
+    release();
+  }
+  void* allocate() {
+    if(freeList == 0) addSlab();
+    Block* b = freeList;
+    freeList = b->next;
+    live++;
+    if(checked) mark(b, true);
+    return b;
+  }
+  void deallocate(void* p) {
+    if(!p) return; // Check for null pointer
+    if(checked) mark(p, false);
+    Block* b = static_cast<Block*>(p);
+    b->next = freeList;
+    freeList = b;
+    live--;
+  }
+  int inUse() const { return live; }
+  int slabsAllocated() const { return slabCount; }
+  // Return every slab to the heap; only when no
+  // block is in use:
+  void release() {
+    if(live != 0) return;
+    while(slabs) {
+      Slab* next = slabs->next;
+      delete slabs;
+      slabs = next;
+    }
+    freeList = 0;
+    slabCount = 0;
+  }
+};
+
+// class Framis : public PoolAllocated<Framis> ...
+template<class T, int N = 100, bool checked = false>
+class PoolAllocated {
+public:
+  typedef FixedPool<T, N, checked> Pool;
+  // Never destroyed: static objects may still be
+  // deleted after it would have been.
+  static Pool& pool() {
+    static Pool* p = new Pool;
+    return *p;
+  }
+  // A larger derived class uses the global heap:
+  static void* operator new(std::size_t sz) {
+    if(sz != sizeof(T))
+      return ::operator new(sz);
+    return pool().allocate();
+  }
+  static void operator delete(void* m,
+    std::size_t sz) {
+    if(sz != sizeof(T))
+      ::operator delete(m);
+    else
+      pool().deallocate(m);
+  }
+};
+#endif // FIXEDPOOL_H ///:~
@@ -0,0 +1,56 @@
+//: C13:FixedPoolTest.cpp
+// Framis on PoolAllocated: more objects than one
+// slab holds, block reuse, and a derived class
+// that falls back to the global heap
+#include "FixedPool.h"
+#include "../require.h"
+#include <iostream>
+using namespace std;
+
+class Framis
+  : public PoolAllocated<Framis, 10, true> {
+  enum { sz = 10 };
+  char c[sz]; // To take up space, not used
+public:
+  Framis() { cout << "Framis() "; }
+  virtual ~Framis() { cout << "~Framis() "; }
+};
+
+class BigFramis : public Framis {
+  char more[100];
+public:
+  ~BigFramis() { cout << "~BigFramis() "; }
+};
+
+int main() {
+  enum { count = 25 }; // Two and a half slabs
+  Framis* f[count];
+  for(int i = 0; i < count; i++)
+    f[i] = new Framis;
+  cout << endl;
+  require(Framis::pool().inUse() == count &&
+    Framis::pool().slabsAllocated() == 3,
+    "FixedPoolTest: slabs not chained");
+  Framis* freed = f[10];
+  delete f[10];
+  f[10] = 0;
+  // Use released memory:
+  Framis* x = new Framis;
+  require(x == freed,
+    "FixedPoolTest: freed block not reused");
+  delete x;
+  cout << endl;
+  Framis* big = new BigFramis;
+  require(Framis::pool().inUse() == count - 1,
+    "FixedPoolTest: BigFramis came from the pool");
+  delete big;
+  cout << endl;
+  for(int j = 0; j < count; j++)
+    delete f[j]; // Delete f[10] OK
+  cout << endl;
+  require(Framis::pool().inUse() == 0,
+    "FixedPoolTest: blocks still in use");
+  Framis::pool().release();
+  require(Framis::pool().slabsAllocated() == 0,
+    "FixedPoolTest: release() kept slabs");
+} ///:~
@@ -0,0 +1,76 @@
+//: C13:FixedPoolTiming.cpp
+// new and delete of 16 to 256 byte objects:
+// PoolAllocated against the global allocator.
+// Each round allocates a batch, touches every
+// object and frees them in a scrambled order.
+// Usage: FixedPoolTiming [operations [batch]]
+#include "FixedPool.h"
+#include "../Stopwatch.h"
+#include "../require.h"
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+using namespace std;
+
+template<int size>
+struct Plain {
+  char c[size];
+};
+
+template<int size>
+struct Pooled
+  : public PoolAllocated<Pooled<size>, 256> {
+  char c[size];
+};
+
+long touched = 0;
+
+template<class Obj>
+double time(long operations, vector<Obj*>& batch,
+  const vector<int>& order) {
+  int n = batch.size();
+  Stopwatch sw;
+  for(long done = 0; done < operations; done += n) {
+    for(int i = 0; i < n; i++) {
+      batch[i] = new Obj;
+      batch[i]->c[0] = char(i);
+    }
+    for(int i = 0; i < n; i++) {
+      touched += batch[order[i]]->c[0];
+      delete batch[order[i]];
+    }
+  }
+  return sw.nanosPer(operations);
+}
+
+template<int size>
+void row(long operations, const vector<int>& order) {
+  vector<Plain<size>*> plain(order.size());
+  vector<Pooled<size>*> pooled(order.size());
+  double p = time(operations, pooled, order);
+  double g = time(operations, plain, order);
+  cout << size << "\t" << g << "\t\t" << p << endl;
+}
+
+int main(int argc, char* argv[]) {
+  long operations = 10000000;
+  int batch = 1000;
+  if(argc > 1) operations = atol(argv[1]);
+  if(argc > 2) batch = atoi(argv[2]);
+  require(operations > 0 && batch > 0,
+    "FixedPoolTiming: bad arguments");
+  vector<int> order(batch);
+  for(int i = 0; i < batch; i++)
+    order[i] = i;
+  srand(47);
+  for(int i = batch - 1; i > 0; i--)
+    swap(order[i], order[rand() % (i + 1)]);
+  cout << "bytes\tnew/delete\tPoolAllocated"
+          "  [ns per new+delete]" << endl;
+  row<16>(operations, order);
+  row<32>(operations, order);
+  row<64>(operations, order);
+  row<128>(operations, order);
+  row<256>(operations, order);
+  cout << "(" << touched << ")" << endl;
+} ///:~
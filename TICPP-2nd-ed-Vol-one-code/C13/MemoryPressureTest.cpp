@@ -0,0 +1,92 @@
+//: C13:MemoryPressureTest.cpp
+// Surviving an address-space cap. A NodePool and
+// an Arena hold 96 MB they no longer use; with
+// the soft limit leaving room for only 48 MB
+// more, an 80 MB working set still fits because
+// the new_handler trims the caches. Past that
+// the soft limit is lifted, and beyond the hard
+// limit new throws instead of killing the
+// process.
+#include "../MemoryPressure.h"
+#include "../NodePool.h"
+#include "../Arena.h"
+#include "../require.h"
+#include <cstdio>
+#include <iostream>
+#include <new>
+#include <unistd.h>
+using namespace std;
+
+struct Page {
+  char bytes[4096];
+};
+
+const size_t MB = 1 << 20;
+
+size_t addressSpace() {
+  FILE* f = fopen("/proc/self/statm", "r");
+  require(f != 0, "MemoryPressureTest: statm");
+  unsigned long pages = 0;
+  if(fscanf(f, "%lu", &pages) != 1) pages = 0;
+  fclose(f);
+  return pages * sysconf(_SC_PAGESIZE);
+}
+
+int main() {
+  MemoryPressure::install();
+  NodePool<Page> pool(64);
+  {
+    enum { pages = 64 * MB / sizeof(Page) };
+    static void* held[pages];
+    for(int i = 0; i < pages; i++)
+      held[i] = pool.allocate();
+    for(int i = 0; i < pages; i++)
+      pool.deallocate(held[i]);
+  }
+  Arena arena(MB);
+  for(int i = 0; i < 32; i++)
+    arena.allocate(MB - 1024);
+  arena.reset();
+  // The arena is cheaper to refill, trim it first:
+  MemoryPressure::Trimmer<Arena> a(arena, 0);
+  MemoryPressure::Trimmer<NodePool<Page> > p(pool, 1);
+  size_t base = addressSpace();
+  rlimit hard = { 0, 0 };
+  getrlimit(RLIMIT_AS, &hard);
+  hard.rlim_max = hard.rlim_cur = base + 256 * MB;
+  require(setrlimit(RLIMIT_AS, &hard) == 0,
+    "MemoryPressureTest: setrlimit");
+  require(MemoryPressure::setSoftLimit(
+    base + 48 * MB), "MemoryPressureTest: soft limit");
+  enum { blocks = 80 };
+  char* work[blocks];
+  for(int i = 0; i < blocks; i++) {
+    work[i] = new char[MB];
+    work[i][0] = char(i);
+  }
+  cout << blocks << " MB allocated under a 48 MB "
+       << "allowance: " << MemoryPressure::trims()
+       << " trims released "
+       << MemoryPressure::released() / MB << " MB"
+       << endl;
+  require(MemoryPressure::trims() > 0 &&
+    MemoryPressure::softLimitActive(),
+    "MemoryPressureTest: caches not trimmed");
+  // Nothing left to trim: the soft limit goes
+  char* more = new char[128 * MB];
+  more[0] = 1;
+  require(!MemoryPressure::softLimitActive(),
+    "MemoryPressureTest: soft limit kept");
+  cout << "soft limit lifted for 128 MB more" << endl;
+  try {
+    char* tooMuch = new char[512 * MB];
+    tooMuch[0] = 1;
+    require(false, "MemoryPressureTest: hard limit");
+  } catch(bad_alloc&) {
+    cout << "past the hard limit: bad_alloc, "
+         << "still running" << endl;
+  }
+  delete []more;
+  for(int i = 0; i < blocks; i++)
+    delete []work[i];
+} ///:~
@@ -12,6 +12,11 @@ using namespace std;
 
 int PStash::add(void* element) {
   const int inflateSize = 10;
+  if(holeCount > 0) { // Fill a hole first
+    int index = holes[--holeCount];
+    storage[index] = element;
+    return index;
+  }
   if(next >= quantity)
     inflate(inflateSize);
   storage[next++] = element;
@@ -24,6 +29,7 @@ PStash::~PStash() {
     require(storage[i] == 0, 
       "PStash not cleaned up");
   delete []storage; 
+  delete []holes;
 }
 
 // Operator overloading replacement for fetch
@@ -39,16 +45,40 @@ void* PStash::operator[](int index) const {
 void* PStash::remove(int index) {
   void* v = operator[](index);
   // "Remove" the pointer:
-  if(v != 0) storage[index] = 0;
+  if(v != 0) {
+    storage[index] = 0;
+    holes[holeCount++] = index;
+  }
   return v;
 }
 
+vector<int> PStash::compact() {
+  vector<int> remap(next, -1);
+  int live = 0;
+  for(int i = 0; i < next; i++)
+    if(storage[i] != 0) {
+      remap[i] = live;
+      storage[live++] = storage[i];
+    }
+  for(int i = live; i < next; i++)
+    storage[i] = 0;
+  next = live;
+  holeCount = 0;
+  return remap;
+}
+
 void PStash::inflate(int increase) {
   const int psz = sizeof(void*);
   void** st = new void*[quantity + increase];
   memset(st, 0, (quantity + increase) * psz);
   memcpy(st, storage, quantity * psz);
+  // At most one hole per slot:
+  int* h = new int[quantity + increase];
+  if(holes)
+    memcpy(h, holes, holeCount * sizeof(int));
   quantity += increase;
   delete []storage; // Old storage
   storage = st; // Point to new memory
+  delete []holes;
+  holes = h;
 } ///:~
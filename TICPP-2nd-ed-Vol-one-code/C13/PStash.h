@@ -6,21 +6,33 @@
 // Holds pointers instead of objects
 #ifndef PSTASH_H
 #define PSTASH_H
+#include <vector>
 
 class PStash {
   int quantity; // Number of storage spaces
   int next; // Next empty space
    // Pointer storage:
   void** storage;
+  // Indices of removed slots, reused by add():
+  int* holes;
+  int holeCount;
   void inflate(int increase);
 public:
-  PStash() : quantity(0), storage(0), next(0) {}
+  PStash() : quantity(0), next(0), storage(0),
+    holes(0), holeCount(0) {}
   ~PStash();
   int add(void* element);
   void* operator[](int index) const; // Fetch
   // Remove the reference from this PStash:
   void* remove(int index);
-  // Number of elements in Stash:
+  // Number of elements in Stash (the limit for
+  // indexing, removed slots included):
   int count() const { return next; }
+  int live() const { return next - holeCount; }
+  int dead() const { return holeCount; }
+  int capacity() const { return quantity; }
+  // Close the holes; remap[old index] is the new
+  // index, or -1 for a removed slot:
+  std::vector<int> compact();
 };
 #endif // PSTASH_H ///:~
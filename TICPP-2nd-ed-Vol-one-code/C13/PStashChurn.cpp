@@ -0,0 +1,68 @@
+//: C13:PStashChurn.cpp
+//{L} PStash
+// Steady-state churn: one random remove and one
+// add per step with the live count held
+// constant. add() refills the removed slots, so
+// count() and the storage stop growing; compact()
+// then squeezes out the holes left at the end.
+// Usage: PStashChurn [live [steps]]
+#include "PStash.h"
+#include "../Stopwatch.h"
+#include "../require.h"
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+using namespace std;
+
+void report(long step, const PStash& ps) {
+  cout << step << "\t" << ps.live() << "\t"
+       << ps.dead() << "\t" << ps.count() << "\t"
+       << ps.capacity() * (sizeof(void*) +
+            sizeof(int)) << endl;
+}
+
+int main(int argc, char* argv[]) {
+  int live = 10000;
+  long steps = 2000000;
+  if(argc > 1) live = atoi(argv[1]);
+  if(argc > 2) steps = atol(argv[2]);
+  require(live > 0 && steps > 0,
+    "PStashChurn: bad arguments");
+  PStash ps;
+  for(int i = 0; i < live; i++)
+    ps.add(new int(i));
+  srand(47);
+  cout << "step\tlive\tdead\tcount\tbytes" << endl;
+  report(0, ps);
+  Stopwatch sw;
+  for(long s = 1; s <= steps; s++) {
+    int victim;
+    do
+      victim = rand() % ps.count();
+    while(ps[victim] == 0);
+    delete (int*)ps.remove(victim);
+    ps.add(new int(victim));
+    if(s % (steps / 10 > 0 ? steps / 10 : 1) == 0)
+      report(s, ps);
+  }
+  cout << sw.nanosPer(steps)
+       << " ns per remove + add" << endl;
+  require(ps.count() == live,
+    "PStashChurn: holes not reused");
+  // Leave every third slot empty, then compact:
+  for(int i = 0; i < ps.count(); i += 3)
+    delete (int*)ps.remove(i);
+  int before = ps.count();
+  vector<int> remap = ps.compact();
+  require(ps.dead() == 0 &&
+    ps.count() == ps.live(),
+    "PStashChurn: compact left holes");
+  for(int i = 0; i < before; i++)
+    if(remap[i] >= 0)
+      require(ps[remap[i]] != 0,
+        "PStashChurn: bad remap");
+  cout << "compact: " << before << " -> "
+       << ps.count() << " slots" << endl;
+  for(int i = 0; i < ps.count(); i++)
+    delete (int*)ps.remove(i);
+} ///:~
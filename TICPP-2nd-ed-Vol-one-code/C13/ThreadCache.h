@@ -0,0 +1,105 @@
+//: C13:ThreadCache.h
+// Per-thread front end for class-specific pools.
+// Each thread keeps up to 2 * M free blocks of
+// its own and new and delete only touch that
+// cache. An empty cache takes M blocks from the
+// shared depot (spare blocks, then a FixedPool),
+// and a full one gives back its M oldest, so the
+// depot lock is taken once per M operations
+// instead of on every call. Any thread may delete
+// any object: the block joins the deleting
+// thread's cache, and a thread's cache goes back
+// to the depot when the thread exits.
+#ifndef THREADCACHE_H
+#define THREADCACHE_H
+#include "FixedPool.h"
+#include <cstddef>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <vector>
+
+// class Job : public ThreadCached<Job> ...
+template<class T, int M = 64>
+class ThreadCached {
+  class Depot {
+    std::mutex lock;
+    FixedPool<T, 16 * M> pool;
+    std::vector<void*> spare;
+  public:
+    // Fill blocks[0, M):
+    void refill(void** blocks) {
+      std::lock_guard<std::mutex> guard(lock);
+      int i = 0;
+      for(; i < M && !spare.empty(); i++) {
+        blocks[i] = spare.back();
+        spare.pop_back();
+      }
+      for(; i < M; i++)
+        blocks[i] = pool.allocate();
+    }
+    void drain(void** blocks, int n) {
+      std::lock_guard<std::mutex> guard(lock);
+      spare.insert(spare.end(), blocks, blocks + n);
+    }
+    // Blocks carved from slabs, in a thread's
+    // cache, in use or spare:
+    int carved() {
+      std::lock_guard<std::mutex> guard(lock);
+      return pool.inUse();
+    }
+    int spares() {
+      std::lock_guard<std::mutex> guard(lock);
+      return int(spare.size());
+    }
+  };
+  struct Cache {
+    void* blocks[2 * M];
+    int n;
+    Cache() : n(0) {}
+    ~Cache() { depot().drain(blocks, n); }
+  };
+  static Cache& cache() {
+    static thread_local Cache c;
+    return c;
+  }
+public:
+  // Never destroyed, like PoolAllocated's pool:
+  static Depot& depot() {
+    static Depot* d = new Depot;
+    return *d;
+  }
+  // Hand this thread's blocks to the depot now:
+  static void flush() {
+    Cache& c = cache();
+    depot().drain(c.blocks, c.n);
+    c.n = 0;
+  }
+  static void* operator new(std::size_t sz) {
+    if(sz != sizeof(T))
+      return ::operator new(sz);
+    Cache& c = cache();
+    if(c.n == 0) {
+      depot().refill(c.blocks);
+      c.n = M;
+    }
+    return c.blocks[--c.n];
+  }
+  static void operator delete(void* m,
+    std::size_t sz) {
+    if(sz != sizeof(T)) {
+      ::operator delete(m);
+      return;
+    }
+    if(!m) return;
+    Cache& c = cache();
+    if(c.n == 2 * M) { // Keep the M most recent
+      depot().drain(c.blocks, M);
+      std::memcpy(c.blocks, c.blocks + M,
+        M * sizeof(void*));
+      c.n = M;
+    }
+    c.blocks[c.n++] = m;
+  }
+};
+#endif // THREADCACHE_H ///:~
@@ -0,0 +1,85 @@
+//: C13:ThreadCacheTest.cpp
+// Producers create Jobs, consumers on other
+// threads delete them. Every Job is seen once,
+// and when the threads are gone every block is
+// back in the depot.
+#include "ThreadCache.h"
+#include "../require.h"
+#include <atomic>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+using namespace std;
+
+atomic<int> live(0);
+
+class Job : public ThreadCached<Job, 16> {
+  enum { tag = 0x4a6f62 };
+  int check;
+public:
+  int id;
+  Job(int i) : check(tag), id(i) { live++; }
+  ~Job() {
+    require(check == tag,
+      "ThreadCacheTest: Job overwritten");
+    check = 0;
+    live--;
+  }
+};
+
+mutex queueLock;
+deque<Job*> queue;
+
+int main() {
+  const int producers = 4, consumers = 4;
+  const int perProducer = 50000;
+  const int total = producers * perProducer;
+  vector<atomic<char> > seen(total);
+  for(int i = 0; i < total; i++)
+    seen[i].store(0);
+  atomic<int> consumed(0);
+  vector<thread> threads;
+  for(int p = 0; p < producers; p++)
+    threads.push_back(thread([&, p] {
+      for(int i = 0; i < perProducer; i++) {
+        Job* j = new Job(p * perProducer + i);
+        lock_guard<mutex> guard(queueLock);
+        queue.push_back(j);
+      }
+    }));
+  for(int c = 0; c < consumers; c++)
+    threads.push_back(thread([&] {
+      while(consumed.load() < total) {
+        Job* j = 0;
+        {
+          lock_guard<mutex> guard(queueLock);
+          if(!queue.empty()) {
+            j = queue.front();
+            queue.pop_front();
+          }
+        }
+        if(!j) {
+          this_thread::yield();
+          continue;
+        }
+        require(seen[j->id].fetch_add(1) == 0,
+          "ThreadCacheTest: Job seen twice");
+        delete j; // Not the allocating thread
+        consumed++;
+      }
+    }));
+  for(size_t i = 0; i < threads.size(); i++)
+    threads[i].join();
+  require(live.load() == 0,
+    "ThreadCacheTest: Jobs not destroyed");
+  // Exited threads flushed their caches:
+  Job::flush();
+  int carved = Job::depot().carved();
+  require(Job::depot().spares() == carved,
+    "ThreadCacheTest: blocks lost");
+  cout << total << " Jobs freed across threads, "
+       << carved << " blocks back in the depot"
+       << endl;
+} ///:~
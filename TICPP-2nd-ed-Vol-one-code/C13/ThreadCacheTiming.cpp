@@ -0,0 +1,75 @@
+//: C13:ThreadCacheTiming.cpp
+// new and delete of 64-byte objects from 1 to 64
+// threads: ThreadCached against malloc (the
+// global operator new). Each thread allocates a
+// batch and frees it in a scrambled order.
+// Usage: ThreadCacheTiming [opsPerThread [batch]]
+#include "ThreadCache.h"
+#include "../Stopwatch.h"
+#include "../require.h"
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+using namespace std;
+
+struct Plain {
+  char c[64];
+};
+
+struct Cached : public ThreadCached<Cached> {
+  char c[64];
+};
+
+template<class Obj>
+void churn(long ops, const vector<int>& order,
+  long& touched) {
+  int n = order.size();
+  vector<Obj*> batch(n);
+  for(long done = 0; done < ops; done += n) {
+    for(int i = 0; i < n; i++) {
+      batch[i] = new Obj;
+      batch[i]->c[0] = char(i);
+    }
+    for(int i = 0; i < n; i++) {
+      touched += batch[order[i]]->c[0];
+      delete batch[order[i]];
+    }
+  }
+}
+
+// Million new+delete pairs per second:
+template<class Obj>
+double rate(int nThreads, long ops,
+  const vector<int>& order) {
+  vector<long> touched(nThreads);
+  vector<thread> threads;
+  Stopwatch sw;
+  for(int t = 0; t < nThreads; t++)
+    threads.push_back(thread(churn<Obj>, ops,
+      cref(order), ref(touched[t])));
+  for(int t = 0; t < nThreads; t++)
+    threads[t].join();
+  return ops * nThreads / sw.seconds() / 1e6;
+}
+
+int main(int argc, char* argv[]) {
+  long ops = 1000000;
+  int batch = 256;
+  if(argc > 1) ops = atol(argv[1]);
+  if(argc > 2) batch = atoi(argv[2]);
+  require(ops > 0 && batch > 0,
+    "ThreadCacheTiming: bad arguments");
+  vector<int> order(batch);
+  for(int i = 0; i < batch; i++)
+    order[i] = i;
+  srand(47);
+  for(int i = batch - 1; i > 0; i--)
+    swap(order[i], order[rand() % (i + 1)]);
+  cout << "threads\tmalloc\tThreadCached"
+          "  [M new+delete per s]" << endl;
+  for(int n = 1; n <= 64; n *= 2)
+    cout << n << "\t" << rate<Plain>(n, ops, order)
+         << "\t" << rate<Cached>(n, ops, order)
+         << endl;
+} ///:~
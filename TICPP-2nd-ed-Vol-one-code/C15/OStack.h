@@ -6,6 +6,7 @@
 // Using a singly-rooted hierarchy
 #ifndef OSTACK_H
 #define OSTACK_H
+#include "../NodePool.h"
 
 class Object {
 public:
@@ -22,6 +23,7 @@ class Stack {
     Link(Object* dat, Link* nxt) : 
       data(dat), next(nxt) {}
   }* head;
+  NodePool<Link> pool; // This stack's Links
 public:
   Stack() : head(0) {}
   ~Stack(){ 
@@ -29,7 +31,7 @@ public:
       delete pop();
   }
   void push(Object* dat) {
-    head = new Link(dat, head);
+    head = pool.create(dat, head);
   }
   Object* peek() const { 
     return head ? head->data : 0;
@@ -39,7 +41,7 @@ public:
     Object* result = head->data;
     Link* oldHead = head;
     head = head->next;
-    delete oldHead;
+    pool.destroy(oldHead);
     return result;
   }
 };
@@ -6,6 +6,7 @@
 #ifndef AUTOCOUNTER_H
 #define AUTOCOUNTER_H
 #include "../require.h"
+#include "../Trace.h"
 #include <iostream>
 #include <set> // Standard C++ Library container
 #include <string>
@@ -32,8 +33,7 @@ class AutoCounter {
   static CleanupCheck verifier;
   AutoCounter() : id(count++) {
     verifier.add(this); // Register itself
-    std::cout << "created[" << id << "]" 
-              << std::endl;
+    TRACE("created[" << id << "]");
   }
   // Prevent assignment and copy-construction:
   AutoCounter(const AutoCounter&);
@@ -44,8 +44,7 @@ public:
     return new AutoCounter();
   }
   ~AutoCounter() {
-    std::cout << "destroying[" << id 
-              << "]" << std::endl;
+    TRACE("destroying[" << id << "]");
     verifier.remove(this);
   }
   // Print both objects and pointers:
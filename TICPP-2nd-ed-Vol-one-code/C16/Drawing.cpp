@@ -6,6 +6,7 @@
 #include <vector> // Uses Standard vector too!
 #include "TPStash2.h"
 #include "TStack2.h"
+#include "UnrolledStack.h"
 #include "Shape.h"
 using namespace std;
 
@@ -15,8 +16,11 @@ public:
   ~Drawing() { cout << "~Drawing" << endl; }
 };
 
-// A Plan is a different container of Shapes:
-class Plan : public Stack<Shape> {
+// A Plan is a different container of Shapes.
+// An UnrolledStack has the same interface as
+// TStack2's Stack but iterates through blocks
+// of pointers instead of a Link per Shape:
+class Plan : public UnrolledStack<Shape> {
 public:
   ~Plan() { cout << "~Plan" << endl; }
 };
@@ -0,0 +1,63 @@
+//: C16:NodePoolTiming.cpp
+// push/pop throughput of the TStack2 Stack with
+// Links from new/delete (HeapNodes) and from a
+// per-stack slab with a freelist (NodePool).
+// Usage: NodePoolTiming [operations]
+#include "TStack2.h"
+#include "../NodePool.h"
+#include "../Stopwatch.h"
+#include "../require.h"
+#include <cstdlib>
+#include <iostream>
+using namespace std;
+
+int item;
+long popped; // Keeps the pops observable
+
+// Fill to depth, then drain, repeatedly:
+template<template<class> class Alloc>
+double fillDrain(long ops, int depth) {
+  Stack<int, Alloc> s;
+  Stopwatch sw;
+  for(long done = 0; done < ops; done += 2 * depth) {
+    for(int i = 0; i < depth; i++)
+      s.push(&item);
+    for(int i = 0; i < depth; i++)
+      popped += (s.pop() == &item);
+  }
+  return sw.nanosPer(ops);
+}
+
+// Steady churn: a few pushes, a few pops:
+template<template<class> class Alloc>
+double churn(long ops) {
+  Stack<int, Alloc> s;
+  for(int i = 0; i < 1000; i++)
+    s.push(&item);
+  Stopwatch sw;
+  for(long done = 0; done < ops; done += 6) {
+    s.push(&item); s.push(&item); s.push(&item);
+    popped += (s.pop() == &item);
+    popped += (s.pop() == &item);
+    popped += (s.pop() == &item);
+  }
+  double ns = sw.nanosPer(ops);
+  while(s.pop())
+    ;
+  return ns;
+}
+
+int main(int argc, char* argv[]) {
+  long ops = 20000000;
+  if(argc > 1) ops = atol(argv[1]);
+  require(ops > 0, "NodePoolTiming: bad count");
+  cout << "pattern\t\tHeapNodes\tNodePool"
+          "  [ns per push or pop]" << endl;
+  cout << "fill/drain 100\t" << fillDrain<HeapNodes>(ops, 100)
+       << "\t" << fillDrain<NodePool>(ops, 100) << endl;
+  cout << "fill/drain 100K\t"
+       << fillDrain<HeapNodes>(ops, 100000)
+       << "\t" << fillDrain<NodePool>(ops, 100000) << endl;
+  cout << "churn\t\t" << churn<HeapNodes>(ops)
+       << "\t" << churn<NodePool>(ops) << endl;
+} ///:~
@@ -6,20 +6,25 @@
 // Stack with runtime conrollable ownership
 #ifndef OWNERSTACK_H
 #define OWNERSTACK_H
+#include "../NodePool.h"
 
-template<class T> class Stack {
+// Alloc supplies the Links (see TStack.h):
+template<class T,
+  template<class> class Alloc = NodePool>
+class Stack {
   struct Link {
     T* data;
     Link* next;
     Link(T* dat, Link* nxt) 
       : data(dat), next(nxt) {}
   }* head;
+  Alloc<Link> links;
   bool own;
 public:
   Stack(bool own = true) : head(0), own(own) {}
   ~Stack();
   void push(T* dat) {
-    head = new Link(dat,head);
+    head = links.create(dat, head);
   }
   T* peek() const { 
     return head ? head->data : 0; 
@@ -33,16 +38,18 @@ public:
   operator bool() const { return head != 0; }
 };
 
-template<class T> T* Stack<T>::pop() {
+template<class T, template<class> class Alloc>
+T* Stack<T, Alloc>::pop() {
   if(head == 0) return 0;
   T* result = head->data;
   Link* oldHead = head;
   head = head->next;
-  delete oldHead;
+  links.destroy(oldHead);
   return result;
 }
 
-template<class T> Stack<T>::~Stack() {
+template<class T, template<class> class Alloc>
+Stack<T, Alloc>::~Stack() {
   if(!own) return;
   while(head)
     delete pop();
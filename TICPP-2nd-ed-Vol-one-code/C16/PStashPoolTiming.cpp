@@ -0,0 +1,83 @@
+//: C16:PStashPoolTiming.cpp
+// Add/remove/destroy cycles: every round fills
+// a PStash from TPStash3.h, walks it, removes
+// half the elements and destroys it. The
+// baseline does what TPStash2 does: one new per
+// element and one delete per element.
+// Usage: PStashPoolTiming [elements [perRound]]
+#include "TPStash3.h"
+#include "../Stopwatch.h"
+#include "../require.h"
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+long alive = 0;
+
+class Particle {
+  double x, y, z;
+  int id;
+public:
+  Particle(int i) : x(i), y(i * 0.5), z(0), id(i) {
+    alive++;
+  }
+  ~Particle() { alive--; }
+  double weight() const { return x + y + z; }
+};
+
+double checksum = 0;
+
+double pooled(long elements, int perRound) {
+  Stopwatch sw;
+  for(long done = 0; done < elements;
+    done += perRound) {
+    PStash<Particle> ps;
+    for(int i = 0; i < perRound; i++)
+      ps.emplace(i);
+    for(PStash<Particle>::iterator it = ps.begin();
+      it != ps.end(); it++)
+      checksum += it->weight();
+    for(int i = 0; i < perRound; i += 2)
+      ps.remove(i);
+  } // Remaining half goes with the slabs
+  return sw.nanosPer(elements);
+}
+
+double heap(long elements, int perRound) {
+  Stopwatch sw;
+  for(long done = 0; done < elements;
+    done += perRound) {
+    vector<Particle*> ps;
+    for(int i = 0; i < perRound; i++)
+      ps.push_back(new Particle(i));
+    for(size_t i = 0; i < ps.size(); i++)
+      checksum += ps[i]->weight();
+    for(int i = 0; i < perRound; i += 2) {
+      delete ps[i];
+      ps[i] = 0;
+    }
+    for(size_t i = 0; i < ps.size(); i++)
+      delete ps[i];
+  }
+  return sw.nanosPer(elements);
+}
+
+int main(int argc, char* argv[]) {
+  long elements = 10000000;
+  int perRound = 1000;
+  if(argc > 1) elements = atol(argv[1]);
+  if(argc > 2) perRound = atoi(argv[2]);
+  require(elements > 0 && perRound > 0,
+    "PStashPoolTiming: bad arguments");
+  cout << elements << " elements, " << perRound
+       << " per stash" << endl;
+  cout << "new/delete each\t" << heap(elements,
+    perRound) << " ns per element" << endl;
+  cout << "PStash pool\t" << pooled(elements,
+    perRound) << " ns per element" << endl;
+  require(alive == 0,
+    "PStashPoolTiming: elements leaked");
+  cout << "(checksum " << checksum << ")" << endl;
+} ///:~
@@ -0,0 +1,19 @@
+//: C16:StackTemplate2.h
+// StackTemplate on ValueStack2's storage: no
+// default construction and no 100-element limit
+#ifndef STACKTEMPLATE2_H
+#define STACKTEMPLATE2_H
+#include "ValueStack2.h"
+#include <utility>
+
+template<class T>
+class StackTemplate {
+  enum { ssize = 100 };
+  Stack<T, ssize> stack;
+public:
+  void push(const T& i) { stack.push(i); }
+  void push(T&& i) { stack.push(std::move(i)); }
+  T pop() { return stack.pop(); }
+  int size() { return stack.size(); }
+};
+#endif // STACKTEMPLATE2_H ///:~
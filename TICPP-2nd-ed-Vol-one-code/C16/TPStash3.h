@@ -0,0 +1,205 @@
+//: C16:TPStash3.h
+// Owning PStash that creates its own elements:
+// emplace() constructs a T in a slab of the
+// stash's NodePool and returns the index. The
+// destructor runs the element destructors and
+// hands the slabs back in bulk, and elements
+// created in order sit side by side in memory,
+// so iteration walks contiguous slabs instead
+// of objects scattered over the heap.
+#ifndef TPSTASH3_H
+#define TPSTASH3_H
+#include "../require.h"
+#include "../Growth.h"
+#include "../NodePool.h"
+#include <cassert>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+template<class T>
+class PStash {
+  int quantity;
+  int next;
+  T** storage;   // Null where an element was removed
+  int* holes;    // Removed slots, reused first
+  int holeCount;
+  Growth growth;
+  NodePool<T> pool;
+  void inflate(int increase);
+  void destroyAll();
+  PStash(const PStash&);
+  void operator=(const PStash&);
+public:
+  PStash(int perSlab = 256,
+    Growth g = geometricGrowth())
+    : quantity(0), next(0), storage(0),
+    holes(0), holeCount(0), growth(g),
+    pool(perSlab) {}
+  ~PStash();
+  // Construct a T from args inside the stash:
+  template<class... Args>
+  int emplace(Args&&... args);
+  T* operator[](int index) const;
+  // The stash owns the memory, so remove()
+  // destroys the element instead of handing it
+  // back; false if the slot was already empty:
+  bool remove(int index);
+  // Destroy every element and free the slabs:
+  void clear();
+  int count() const { return next; }
+  int live() const { return pool.inUse(); }
+  int dead() const { return holeCount; }
+  // Give back pool slabs with no live element
+  // (see MemoryPressure.h):
+  std::size_t trim() { return pool.trim(); }
+  // Close the holes; remap[old index] is the new
+  // index, or -1 for a removed slot:
+  std::vector<int> compact();
+  class iterator;
+  friend class iterator;
+  class iterator {
+    PStash* ps;
+    int index;
+  public:
+    iterator(PStash& pStash)
+      : ps(&pStash), index(0) {}
+    // To create the end sentinel:
+    iterator(PStash& pStash, bool)
+      : ps(&pStash), index(pStash.next) {}
+    // assert() rather than require(): these run
+    // once per element
+    iterator& operator++() {
+      assert(index < ps->next);
+      ++index;
+      return *this;
+    }
+    iterator& operator++(int) {
+      return operator++();
+    }
+    iterator& operator--() {
+      assert(index > 0);
+      --index;
+      return *this;
+    }
+    iterator& operator--(int) {
+      return operator--();
+    }
+    // Zero for a removed element:
+    T* current() const {
+      return ps->storage[index];
+    }
+    T* operator*() const { return current(); }
+    T* operator->() const {
+      assert(current() != 0);
+      return current();
+    }
+    bool remove() { return ps->remove(index); }
+    bool operator==(const iterator& rv) const {
+      return index == rv.index;
+    }
+    bool operator!=(const iterator& rv) const {
+      return index != rv.index;
+    }
+  };
+  iterator begin() { return iterator(*this); }
+  iterator end() { return iterator(*this, true);}
+};
+
+template<class T>
+void PStash<T>::destroyAll() {
+  if(!std::is_trivially_destructible<T>::value)
+    for(int i = 0; i < next; i++)
+      if(storage[i])
+        storage[i]->~T();
+  next = 0;
+  holeCount = 0;
+}
+
+// No delete per element: the slabs go back to
+// the heap all at once when pool is destroyed.
+template<class T>
+PStash<T>::~PStash() {
+  destroyAll();
+  delete []storage;
+  delete []holes;
+}
+
+template<class T>
+void PStash<T>::clear() {
+  destroyAll();
+  pool.reset();
+}
+
+template<class T> template<class... Args>
+int PStash<T>::emplace(Args&&... args) {
+  if(holeCount > 0) { // Fill a hole first
+    int index = holes[holeCount - 1];
+    storage[index] =
+      pool.create(std::forward<Args>(args)...);
+    holeCount--;
+    return index;
+  }
+  if(next >= quantity)
+    inflate(growth.grow(quantity, next + 1,
+      sizeof(T*)) - quantity);
+  storage[next] =
+    pool.create(std::forward<Args>(args)...);
+  return next++; // Index number
+}
+
+template<class T> inline
+T* PStash<T>::operator[](int index) const {
+  assert(index >= 0);
+  if(index >= next)
+    return 0; // To indicate the end
+  return storage[index];
+}
+
+template<class T>
+bool PStash<T>::remove(int index) {
+  T* v = operator[](index);
+  if(v == 0) return false;
+  pool.destroy(v);
+  storage[index] = 0;
+  holes[holeCount++] = index;
+  return true;
+}
+
+template<class T>
+std::vector<int> PStash<T>::compact() {
+  std::vector<int> remap(next, -1);
+  int live = 0;
+  for(int i = 0; i < next; i++)
+    if(storage[i] != 0) {
+      remap[i] = live;
+      storage[live++] = storage[i];
+    }
+  for(int i = live; i < next; i++)
+    storage[i] = 0;
+  next = live;
+  holeCount = 0;
+  return remap;
+}
+
+template<class T>
+void PStash<T>::inflate(int increase) {
+  require(increase > 0,
+    "PStash::inflate zero or negative increase");
+  const int tsz = sizeof(T*);
+  T** st = new T*[quantity + increase];
+  memset(st, 0, (quantity + increase) * tsz);
+  if(storage)
+    memcpy(st, storage, quantity * tsz);
+  // At most one hole per slot:
+  int* h = new int[quantity + increase];
+  if(holes)
+    memcpy(h, holes, holeCount * sizeof(int));
+  quantity += increase;
+  delete []storage; // Old storage
+  storage = st; // Point to new memory
+  delete []holes;
+  holes = h;
+}
+#endif // TPSTASH3_H ///:~
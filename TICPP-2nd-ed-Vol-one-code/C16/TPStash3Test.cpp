@@ -0,0 +1,56 @@
+//: C16:TPStash3Test.cpp
+// PStash creating its own elements
+#include "TPStash3.h"
+#include "../require.h"
+#include <iostream>
+#include <string>
+using namespace std;
+
+class Int {
+  int i;
+public:
+  Int(int ii = 0) : i(ii) {
+    cout << ">" << i << ' ';
+  }
+  ~Int() { cout << "~" << i << ' '; }
+  operator int() const { return i; }
+};
+
+int main() {
+  {
+    PStash<Int> ints;
+    for(int i = 0; i < 30; i++)
+      require(ints.emplace(i) == i,
+        "TPStash3Test: emplace index");
+    cout << endl;
+    PStash<Int>::iterator it = ints.begin();
+    it++;
+    it.remove(); // Destroys 1
+    ints.remove(2);
+    require(!ints.remove(2),
+      "TPStash3Test: removed twice");
+    require(ints.live() == 28 && ints.count() == 30,
+      "TPStash3Test: live count");
+    int sum = 0;
+    for(it = ints.begin(); it != ints.end(); it++)
+      if(*it) sum += **it;
+    cout << endl << "sum = " << sum << endl;
+    require(sum == 29 * 30 / 2 - 3,
+      "TPStash3Test: sum");
+    ints.clear();
+    cout << endl;
+    require(ints.count() == 0 && ints.live() == 0,
+      "TPStash3Test: clear");
+    ints.emplace(100);
+  } // Destroys 100
+  cout << endl;
+  PStash<string> strings(16);
+  for(int i = 0; i < 100; i++)
+    strings.emplace(i % 10, 'a' + i % 26);
+  for(int i = 0; i < 100; i++)
+    require(strings[i]->size() == size_t(i % 10),
+      "TPStash3Test: string contents");
+  require(strings[100] == 0,
+    "TPStash3Test: end indicator");
+  cout << *strings[99] << endl;
+} ///:~
@@ -6,8 +6,12 @@
 // The Stack as a template
 #ifndef TSTACK_H
 #define TSTACK_H
+#include "../NodePool.h"
 
-template<class T>
+// Alloc supplies the Links: NodePool (a slab per
+// stack) or HeapNodes (new/delete per Link):
+template<class T,
+  template<class> class Alloc = NodePool>
 class Stack {
   struct Link {
     T* data;
@@ -15,6 +19,7 @@ class Stack {
     Link(T* dat, Link* nxt): 
       data(dat), next(nxt) {}
   }* head;
+  Alloc<Link> links;
 public:
   Stack() : head(0) {}
   ~Stack(){ 
@@ -22,7 +27,7 @@ public:
       delete pop();
   }
   void push(T* dat) {
-    head = new Link(dat, head);
+    head = links.create(dat, head);
   }
   T* peek() const {
     return head ? head->data : 0; 
@@ -32,7 +37,7 @@ public:
     T* result = head->data;
     Link* oldHead = head;
     head = head->next;
-    delete oldHead;
+    links.destroy(oldHead);
     return result;
   }
 };
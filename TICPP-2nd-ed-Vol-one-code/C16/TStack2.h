@@ -6,19 +6,25 @@
 // Templatized Stack with nested iterator
 #ifndef TSTACK2_H
 #define TSTACK2_H
+#include "../require.h"
+#include "../NodePool.h"
 
-template<class T> class Stack {
+// Alloc supplies the Links (see TStack.h):
+template<class T,
+  template<class> class Alloc = NodePool>
+class Stack {
   struct Link {
     T* data;
     Link* next;
     Link(T* dat, Link* nxt)
       : data(dat), next(nxt) {}
   }* head;
+  Alloc<Link> links;
 public:
   Stack() : head(0) {}
   ~Stack();
   void push(T* dat) {
-    head = new Link(dat, head);
+    head = links.create(dat, head);
   }
   T* peek() const { 
     return head ? head->data : 0;
@@ -30,7 +36,7 @@ public:
   class iterator { // Now define it
     Stack::Link* p;
   public:
-    iterator(const Stack<T>& tl) : p(tl.head) {}
+    iterator(const Stack& tl) : p(tl.head) {}
     // Copy-constructor:
     iterator(const iterator& tl) : p(tl.p) {}
     // The end sentinel iterator:
@@ -70,17 +76,19 @@ public:
   iterator end() const { return iterator(); }
 };
 
-template<class T> Stack<T>::~Stack() {
+template<class T, template<class> class Alloc>
+Stack<T, Alloc>::~Stack() {
   while(head)
     delete pop();
 }
 
-template<class T> T* Stack<T>::pop() {
+template<class T, template<class> class Alloc>
+T* Stack<T, Alloc>::pop() {
   if(head == 0) return 0;
   T* result = head->data;
   Link* oldHead = head;
   head = head->next;
-  delete oldHead;
+  links.destroy(oldHead);
   return result;
 }
 #endif // TSTACK2_H ///:~
@@ -0,0 +1,103 @@
+//: C16:UnrolledStack.h
+// Stack with the TStack2 interface whose Links
+// each hold a block of element pointers, so an
+// iterator touches one node per chunk elements
+// instead of one node per element.
+#ifndef UNROLLEDSTACK_H
+#define UNROLLEDSTACK_H
+#include "../require.h"
+#include "../NodePool.h"
+
+template<class T, int chunk = 64,
+  template<class> class Alloc = NodePool>
+class UnrolledStack {
+  struct Link {
+    T* data[chunk]; // data[used - 1] is the top
+    int used;
+    Link* next;
+    Link(Link* nxt) : used(0), next(nxt) {}
+  }* head;
+  Alloc<Link> links;
+  UnrolledStack(const UnrolledStack&);
+  void operator=(const UnrolledStack&);
+public:
+  UnrolledStack() : head(0) {}
+  ~UnrolledStack();
+  void push(T* dat) {
+    if(head == 0 || head->used == chunk)
+      head = links.create(head);
+    head->data[head->used++] = dat;
+  }
+  T* peek() const {
+    return head ? head->data[head->used - 1] : 0;
+  }
+  T* pop();
+  // Same contract as TStack2's iterator:
+  class iterator;
+  friend class iterator;
+  class iterator {
+    Link* p;
+    int i; // Index into p->data
+  public:
+    iterator(const UnrolledStack& tl)
+      : p(tl.head), i(tl.head ? tl.head->used - 1 : 0) {}
+    iterator(const iterator& tl) : p(tl.p), i(tl.i) {}
+    // The end sentinel iterator:
+    iterator() : p(0), i(0) {}
+    // operator++ returns boolean indicating end:
+    bool operator++() {
+      if(i > 0)
+        i--;
+      else if(p->next) {
+        p = p->next;
+        i = p->used - 1;
+      } else p = 0; // Indicates end of list
+      return bool(p);
+    }
+    bool operator++(int) { return operator++(); }
+    T* current() const {
+      if(!p) return 0;
+      return p->data[i];
+    }
+    T* operator->() const {
+      require(p != 0,
+        "UnrolledStack::iterator::operator->returns 0");
+      return current();
+    }
+    T* operator*() const { return current(); }
+    // bool conversion for conditional test:
+    operator bool() const { return bool(p); }
+    // Comparison to test for end:
+    bool operator==(const iterator&) const {
+      return p == 0;
+    }
+    bool operator!=(const iterator&) const {
+      return p != 0;
+    }
+  };
+  iterator begin() const {
+    return iterator(*this);
+  }
+  iterator end() const { return iterator(); }
+};
+
+template<class T, int chunk,
+  template<class> class Alloc>
+UnrolledStack<T, chunk, Alloc>::~UnrolledStack() {
+  while(head)
+    delete pop();
+}
+
+template<class T, int chunk,
+  template<class> class Alloc>
+T* UnrolledStack<T, chunk, Alloc>::pop() {
+  if(head == 0) return 0;
+  T* result = head->data[--head->used];
+  if(head->used == 0) {
+    Link* oldHead = head;
+    head = head->next;
+    links.destroy(oldHead);
+  }
+  return result;
+}
+#endif // UNROLLEDSTACK_H ///:~
@@ -0,0 +1,78 @@
+//: C16:UnrolledStackTiming.cpp
+// Traversal time for drawAll() over 1M Shapes
+// held in TStack2's Stack (Links from the heap
+// and from a NodePool), an UnrolledStack and a
+// vector<Shape*>.
+// Usage: UnrolledStackTiming [shapes [passes]]
+#include "TStack2.h"
+#include "UnrolledStack.h"
+#include "Shape.h"
+#include "../Stopwatch.h"
+#include "../require.h"
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+using namespace std;
+
+long drawn = 0;
+
+// A Shape cheap enough to time the container:
+class Dot : public Shape {
+public:
+  void draw() { drawn++; }
+  void erase() { drawn--; }
+};
+
+template<class Iter>
+void drawAll(Iter start, Iter end) {
+  while(start != end) {
+    (*start)->draw();
+    start++;
+  }
+}
+
+template<class Container>
+double time(const Container& c, long n, int passes) {
+  drawn = 0;
+  Stopwatch sw;
+  for(int i = 0; i < passes; i++)
+    drawAll(c.begin(), c.end());
+  require(drawn == n * passes,
+    "UnrolledStackTiming: missed shapes");
+  return sw.nanosPer(n * passes);
+}
+
+int main(int argc, char* argv[]) {
+  int n = 1000000, passes = 10;
+  if(argc > 1) n = atoi(argv[1]);
+  if(argc > 2) passes = atoi(argv[2]);
+  require(n > 0 && passes > 0,
+    "UnrolledStackTiming: bad arguments");
+  vector<Shape*> shapes;
+  Stack<Shape, HeapNodes> heapStack;
+  Stack<Shape> poolStack;
+  UnrolledStack<Shape> unrolled;
+  for(int i = 0; i < n; i++) {
+    Shape* s = new Dot;
+    shapes.push_back(s);
+    heapStack.push(s);
+    poolStack.push(s);
+    unrolled.push(s);
+  }
+  cout << "container\t\tns per shape" << endl;
+  cout << "Stack (HeapNodes)\t"
+       << time(heapStack, n, passes) << endl;
+  cout << "Stack (NodePool)\t"
+       << time(poolStack, n, passes) << endl;
+  cout << "UnrolledStack\t\t"
+       << time(unrolled, n, passes) << endl;
+  cout << "vector<Shape*>\t\t"
+       << time(shapes, n, passes) << endl;
+  // The stacks own the Shapes; only one may
+  // delete them:
+  while(heapStack.pop())
+    ;
+  while(poolStack.pop())
+    ;
+  shapes.clear();
+} ///:~
@@ -0,0 +1,87 @@
+//: C16:ValueStack2.h
+// Holding objects by value without constructing
+// the whole array: the inline buffer is raw
+// storage, push() constructs in place and pop()
+// destroys. Past ssize elements the stack moves
+// to the heap and keeps growing (a small-vector),
+// and move-only types are fine.
+#ifndef VALUESTACK2_H
+#define VALUESTACK2_H
+#include "../require.h"
+#include <new>
+#include <utility>
+
+template<class T, int ssize = 100>
+class Stack {
+  alignas(T) unsigned char buffer[ssize * sizeof(T)];
+  T* stack;     // buffer, or heap after a spill
+  int top;
+  int capacity;
+  bool onHeap() const {
+    return (void*)stack != (void*)buffer;
+  }
+  // Every element is in the new block before
+  // any old one is destroyed; if a copy throws,
+  // the stack is left as it was:
+  void grow() {
+    int newCapacity = capacity * 2;
+    T* s = static_cast<T*>(
+      ::operator new(newCapacity * sizeof(T)));
+    int i = 0;
+    try {
+      for(; i < top; i++)
+        ::new(static_cast<void*>(s + i))
+          T(std::move_if_noexcept(stack[i]));
+    } catch(...) {
+      while(i > 0) s[--i].~T();
+      ::operator delete(s);
+      throw;
+    }
+    for(i = 0; i < top; i++)
+      stack[i].~T();
+    if(onHeap())
+      ::operator delete(stack);
+    stack = s;
+    capacity = newCapacity;
+  }
+  Stack(const Stack&);
+  void operator=(const Stack&);
+public:
+  Stack() : stack(reinterpret_cast<T*>(buffer)),
+    top(0), capacity(ssize) {}
+  ~Stack() {
+    while(top > 0)
+      stack[--top].~T();
+    if(onHeap())
+      ::operator delete(stack);
+  }
+  template<class... Args>
+  void emplace(Args&&... args) {
+    if(top == capacity) {
+      // args may refer to an element:
+      T tmp(std::forward<Args>(args)...);
+      grow();
+      ::new(static_cast<void*>(stack + top))
+        T(std::move(tmp));
+    } else
+      ::new(static_cast<void*>(stack + top))
+        T(std::forward<Args>(args)...);
+    top++;
+  }
+  void push(const T& x) { emplace(x); }
+  void push(T&& x) { emplace(std::move(x)); }
+  const T& peek() const {
+    require(top > 0, "peek() on empty Stack");
+    return stack[top - 1];
+  }
+  // The element is moved out and destroyed:
+  T pop() {
+    require(top > 0, "Too many pop()s");
+    T result(std::move(stack[--top]));
+    stack[top].~T();
+    return result;
+  }
+  int size() const { return top; }
+  bool spilled() const { return onHeap(); }
+};
+#endif // VALUESTACK2_H ///:~
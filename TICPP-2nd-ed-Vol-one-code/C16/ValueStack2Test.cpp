@@ -0,0 +1,81 @@
+//: C16:ValueStack2Test.cpp
+//{L} SelfCounter
+// Only pushed objects are ever created, the
+// stack grows past its inline size, a copy
+// that throws while it grows loses nothing, and
+// move-only types can be stored.
+#include "ValueStack2.h"
+#include "StackTemplate2.h"
+#include "SelfCounter.h"
+#include "../require.h"
+#include <iostream>
+#include <memory>
+#include <string>
+using namespace std;
+
+// Its move isn't noexcept, so grow() copies it,
+// and the copy can be made to throw:
+struct Fragile {
+  static int live, copiesLeft; // 0: never throw
+  int v;
+  Fragile(int i) : v(i) { live++; }
+  Fragile(const Fragile& f) : v(f.v) {
+    if(copiesLeft > 0 && --copiesLeft == 0)
+      throw 47;
+    live++;
+  }
+  ~Fragile() { live--; v = -1; }
+};
+int Fragile::live = 0, Fragile::copiesLeft = 0;
+
+int main() {
+  {
+    Stack<SelfCounter> sc;
+    for(int i = 0; i < 10; i++)
+      sc.push(SelfCounter());
+    cout << sc.peek() << endl;
+    for(int k = 0; k < 10; k++)
+      cout << sc.pop() << endl;
+  }
+  Stack<unique_ptr<string>, 4> owners;
+  for(int i = 0; i < 250; i++)
+    owners.push(unique_ptr<string>(
+      new string(to_string(i))));
+  require(owners.spilled(),
+    "ValueStack2Test: no spill past inline size");
+  require(*owners.peek() == "249",
+    "ValueStack2Test: bad top after spill");
+  for(int i = 249; i >= 0; i--)
+    require(*owners.pop() == to_string(i),
+      "ValueStack2Test: bad pop order");
+  {
+    Stack<Fragile, 4> f;
+    for(int i = 0; i < 4; i++)
+      f.emplace(i);
+    Fragile::copiesLeft = 2;
+    bool thrown = false;
+    try {
+      f.emplace(4);
+    } catch(int) {
+      thrown = true;
+    }
+    require(thrown && !f.spilled() &&
+      f.size() == 4 && Fragile::live == 4,
+      "ValueStack2Test: throwing copy lost elements");
+    f.emplace(4);
+    require(f.spilled() && f.size() == 5,
+      "ValueStack2Test: emplace after throw");
+    for(int i = 4; i >= 0; i--)
+      require(f.pop().v == i,
+        "ValueStack2Test: throwing copy changed elements");
+  }
+  require(Fragile::live == 0,
+    "ValueStack2Test: Fragile leaked");
+  StackTemplate<string> strings;
+  for(int i = 0; i < 1000; i++)
+    strings.push(to_string(i));
+  require(strings.size() == 1000,
+    "ValueStack2Test: StackTemplate size");
+  cout << "StackTemplate top: " << strings.pop()
+       << endl;
+} ///:~
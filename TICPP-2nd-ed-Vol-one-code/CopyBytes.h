@@ -0,0 +1,26 @@
+//: :CopyBytes.h
+// Bulk byte copy for the Stash family. The
+// common element sizes get a memcpy with a
+// constant length, which the compiler expands
+// into a few register or vector moves.
+#ifndef COPYBYTES_H
+#define COPYBYTES_H
+#include <cstring>
+
+template<int n>
+inline void copyFixed(void* dest, const void* src) {
+  std::memcpy(dest, src, n);
+}
+
+inline void copyBytes(void* dest, const void* src,
+  int size) {
+  switch(size) {
+    case 4:  copyFixed<4>(dest, src); break;
+    case 8:  copyFixed<8>(dest, src); break;
+    case 16: copyFixed<16>(dest, src); break;
+    case 32: copyFixed<32>(dest, src); break;
+    default:
+      if(size > 0) std::memcpy(dest, src, size);
+  }
+}
+#endif // COPYBYTES_H ///:~
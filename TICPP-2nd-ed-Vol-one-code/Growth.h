@@ -0,0 +1,80 @@
+//: :Growth.h
+// Storage growth policies for the Stash family.
+// fixed adds a constant number of slots, which
+// makes a long run of add() calls quadratic;
+// geometric multiplies the capacity by a factor;
+// paged grows geometrically but rounds the byte
+// size up to a whole number of pages.
+#ifndef GROWTH_H
+#define GROWTH_H
+#include "require.h"
+#include <cassert>
+#include <climits>
+
+struct Growth {
+  enum Policy { fixed, geometric, paged };
+  Policy policy;
+  int increment;  // Slots added per step (fixed)
+  double factor;  // Capacity multiplier
+  int pageSize;   // Bytes per page (paged)
+  // Smallest quantity >= minQuantity that this
+  // policy grows to from the current quantity,
+  // but no more than maxQuantity; a minQuantity
+  // over that limit is an error:
+  long grow(long quantity, long minQuantity,
+    int elementSize, long maxQuantity) const {
+    assert(minQuantity >= 0 && elementSize > 0);
+    require(minQuantity <= maxQuantity,
+      "Growth::grow: storage too large");
+    long q = quantity;
+    switch(policy) {
+      case fixed:
+        q = increment > maxQuantity - quantity ?
+          maxQuantity : quantity + increment;
+        break;
+      case geometric:
+      case paged: {
+        double d = quantity * factor;
+        q = d >= double(maxQuantity) ?
+          maxQuantity : long(d);
+        if(q <= quantity) q = quantity + 1;
+        break;
+      }
+    }
+    if(q < minQuantity) q = minQuantity;
+    if(policy == paged) {
+      long bytes = q * elementSize;
+      bytes = (bytes + pageSize - 1) / pageSize
+        * pageSize;
+      q = bytes / elementSize;
+    }
+    return q < maxQuantity ? q : maxQuantity;
+  }
+  // For the Stashes, whose byte counts are ints:
+  int grow(int quantity, int minQuantity,
+    int elementSize) const {
+    return int(grow(long(quantity),
+      long(minQuantity), elementSize,
+      INT_MAX / elementSize));
+  }
+};
+
+inline Growth fixedGrowth(int increment = 100) {
+  assert(increment > 0);
+  Growth g = { Growth::fixed, increment, 1.0, 0 };
+  return g;
+}
+
+inline Growth geometricGrowth(double factor = 2.0) {
+  assert(factor > 1.0);
+  Growth g = { Growth::geometric, 0, factor, 0 };
+  return g;
+}
+
+inline Growth pagedGrowth(int pageSize = 4096,
+  double factor = 2.0) {
+  assert(pageSize > 0 && factor > 1.0);
+  Growth g = { Growth::paged, 0, factor, pageSize };
+  return g;
+}
+#endif // GROWTH_H ///:~
@@ -0,0 +1,203 @@
+//: :Keywords.h
+// Counts any number of keywords in one pass over
+// the text, with an Aho-Corasick automaton: the
+// keywords' trie plus, for every state and byte,
+// the state to go to next, so each byte of text
+// costs one table lookup however many keywords
+// there are. Bytes that appear in no keyword
+// share one column of the table.
+// By default a keyword only counts as a whole
+// word, as WordCount compares words; with
+// wholeWords false, every occurrence counts,
+// inside other words or overlapping. Matches
+// can also be listed with their byte offsets.
+// A keyword listed twice gets the same count for
+// each copy; its matches name the first copy.
+// count() splits the text as WordCount does and
+// scans the chunks on all cores.
+#ifndef KEYWORDS_H
+#define KEYWORDS_H
+#include "WordCount.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class Keywords {
+public:
+  struct Match {
+    int keyword; // Index in the keyword list
+    std::size_t offset; // Of its first byte
+  };
+private:
+  std::vector<std::string> words;
+  bool whole;
+  int classes; // Columns of next
+  unsigned char cls[256]; // Byte -> column
+  std::vector<int> next; // State * classes + cls
+  std::vector<int> out; // Keyword ending here
+  std::vector<int> dict; // Next state with out
+  std::vector<int> depth;
+  std::vector<int> copy; // Next duplicate, or -1
+  enum { spaceClass = 0 }; // When whole
+  static bool isSpace(unsigned char c) {
+    return c == ' ' || unsigned(c - '\t') <= 4;
+  }
+  void build() {
+    // Give each byte used by a keyword a column;
+    // whitespace (when whole) and unused bytes
+    // get the first ones:
+    int first = whole ? 2 : 1;
+    int col[256];
+    for(int c = 0; c < 256; c++) col[c] = -1;
+    classes = first;
+    for(std::size_t k = 0; k < words.size(); k++)
+      for(char ch : words[k]) {
+        unsigned char c = ch;
+        if(col[c] < 0 && !(whole && isSpace(c)))
+          col[c] = classes++;
+      }
+    for(int c = 0; c < 256; c++)
+      cls[c] = col[c] >= 0 ? col[c] :
+        (whole && isSpace(c) ? spaceClass
+          : first - 1);
+    // The trie; -1 is "no edge yet":
+    std::vector<int> fail(1, 0);
+    next.assign(classes, -1);
+    out.assign(1, -1);
+    copy.assign(words.size(), -1);
+    depth.assign(1, 0);
+    for(std::size_t k = 0; k < words.size(); k++) {
+      int s = 0;
+      for(char ch : words[k]) {
+        int c = cls[(unsigned char)ch];
+        if(next[s * classes + c] < 0) {
+          next[s * classes + c] = int(out.size());
+          next.resize(next.size() + classes, -1);
+          out.push_back(-1);
+          depth.push_back(depth[s] + 1);
+          fail.push_back(0);
+        }
+        s = next[s * classes + c];
+      }
+      if(words[k].empty()) continue;
+      if(out[s] < 0) {
+        out[s] = int(k);
+        continue;
+      }
+      // A duplicate: chain it after the last copy
+      int last = out[s];
+      while(copy[last] >= 0) last = copy[last];
+      copy[last] = int(k);
+    }
+    // Breadth first, so a state's failure state
+    // is finished before the state:
+    dict.assign(out.size(), 0);
+    std::vector<int> queue;
+    for(int c = 0; c < classes; c++) {
+      int& t = next[c];
+      if(t < 0) t = 0;
+      else queue.push_back(t);
+    }
+    for(std::size_t q = 0; q < queue.size(); q++) {
+      int s = queue[q];
+      int f = fail[s];
+      dict[s] = out[f] >= 0 ? f : dict[f];
+      for(int c = 0; c < classes; c++) {
+        int& t = next[s * classes + c];
+        if(t < 0)
+          t = next[f * classes + c];
+        else {
+          fail[t] = next[f * classes + c];
+          queue.push_back(t);
+        }
+      }
+    }
+  }
+  void hit(int k, std::size_t offset,
+    std::vector<long>& counts,
+    std::vector<Match>* matches) const {
+    for(int c = k; c >= 0; c = copy[c])
+      counts[c]++;
+    if(matches) {
+      Match m = { k, offset };
+      matches->push_back(m);
+    }
+  }
+public:
+  Keywords(const std::vector<std::string>& kw,
+    bool wholeWords = true)
+    : words(kw), whole(wholeWords) { build(); }
+  int size() const { return int(words.size()); }
+  const std::string& operator[](int k) const {
+    return words[k];
+  }
+  int states() const { return int(out.size()); }
+  // Add the matches in text[0, n) to counts (one
+  // per keyword) and, if matches isn't 0, list
+  // them in order of where they end. base is
+  // added to each offset.
+  void scan(const char* text, std::size_t n,
+    std::vector<long>& counts,
+    std::vector<Match>* matches = 0,
+    std::size_t base = 0) const {
+    counts.resize(words.size(), 0);
+    const unsigned char* p =
+      reinterpret_cast<const unsigned char*>(text);
+    int s = 0;
+    if(whole) {
+      // Keywords hold no whitespace, so the
+      // state's depth is at most the length of
+      // the word so far; equal means the whole
+      // word is the keyword.
+      std::size_t start = 0;
+      for(std::size_t i = 0; i <= n; i++) {
+        int c = i < n ? cls[p[i]] : int(spaceClass);
+        if(c != spaceClass) {
+          s = next[s * classes + c];
+          continue;
+        }
+        if(out[s] >= 0 &&
+          std::size_t(depth[s]) == i - start)
+          hit(out[s], base + start, counts,
+            matches);
+        s = 0;
+        start = i + 1;
+      }
+      return;
+    }
+    for(std::size_t i = 0; i < n; i++) {
+      s = next[s * classes + cls[p[i]]];
+      for(int t = out[s] >= 0 ? s : dict[s];
+        t != 0; t = dict[t])
+        hit(out[t], base + i + 1 - depth[t],
+          counts, matches);
+    }
+  }
+  // scan() on threads chunks of the text, cut
+  // at whitespace. Matches across a cut are
+  // missed only for keywords holding whitespace.
+  std::vector<long> count(const char* text,
+    std::size_t n, std::vector<Match>* matches = 0,
+    int threads = WordCount::defaultThreads()) const {
+    if(threads < 1) threads = 1;
+    std::vector<std::size_t> cuts =
+      WordCount::chunks(text, n, threads);
+    std::vector<std::vector<long> > counts(threads);
+    std::vector<std::vector<Match> > found(threads);
+    WordCount::inParallel(threads, [&](int t) {
+      scan(text + cuts[t], cuts[t + 1] - cuts[t],
+        counts[t], matches ? &found[t] : 0,
+        cuts[t]);
+    });
+    std::vector<long> total(words.size(), 0);
+    for(int t = 0; t < threads; t++) {
+      for(std::size_t k = 0; k < total.size(); k++)
+        total[k] += counts[t][k];
+      if(matches)
+        matches->insert(matches->end(),
+          found[t].begin(), found[t].end());
+    }
+    return total;
+  }
+};
+#endif // KEYWORDS_H ///:~
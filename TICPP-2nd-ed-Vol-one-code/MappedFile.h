@@ -0,0 +1,75 @@
+//: :MappedFile.h
+// A read-only memory mapping of a whole file.
+// Reading through data() costs no copy and no
+// per-line or per-word allocation, and the file
+// may be larger than RAM: the kernel pages it in
+// and out as it is read. Like ifstream, a file
+// that can't be opened sets fail() rather than
+// throwing. POSIX only.
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+class MappedFile {
+  const char* p;
+  std::size_t n;
+  bool failed;
+  MappedFile(const MappedFile&);
+  void operator=(const MappedFile&);
+  void open(const char* path) {
+    int fd = ::open(path, O_RDONLY);
+    if(fd < 0) return;
+    struct stat st;
+    if(fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+      failed = false;
+      n = std::size_t(st.st_size);
+      if(n > 0) { // mmap() refuses length 0
+        void* m = mmap(0, n, PROT_READ,
+          MAP_PRIVATE, fd, 0);
+        if(m == MAP_FAILED) {
+          failed = true;
+          n = 0;
+        } else {
+          p = static_cast<const char*>(m);
+          // Mostly read front to back:
+          madvise(m, n, MADV_SEQUENTIAL);
+        }
+      }
+    }
+    ::close(fd); // The mapping keeps the file
+  }
+public:
+  explicit MappedFile(const char* path)
+    : p(""), n(0), failed(true) { open(path); }
+  explicit MappedFile(const std::string& path)
+    : p(""), n(0), failed(true) {
+    open(path.c_str());
+  }
+  ~MappedFile() {
+    if(n > 0) munmap(const_cast<char*>(p), n);
+  }
+  bool fail() const { return failed; }
+  const char* data() const { return p; }
+  std::size_t size() const { return n; }
+  std::string_view view() const {
+    return std::string_view(p, n);
+  }
+  // Finished with bytes [from, to): give their
+  // pages back now rather than when memory runs
+  // short. Reading them again still works.
+  void release(std::size_t from, std::size_t to) {
+    const std::size_t page = sysconf(_SC_PAGESIZE);
+    from = (from + page - 1) / page * page;
+    to = to / page * page;
+    if(from < to)
+      madvise(const_cast<char*>(p) + from,
+        to - from, MADV_DONTNEED);
+  }
+};
+#endif // MAPPEDFILE_H ///:~
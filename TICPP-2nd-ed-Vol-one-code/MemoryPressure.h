@@ -0,0 +1,154 @@
+//: :MemoryPressure.h
+// What to do instead of exit(1) when memory runs
+// out. Pools and caches that hold memory they
+// could give back derive from
+// MemoryPressure::Cache (or are wrapped in a
+// Trimmer). The installed new_handler trims them,
+// lowest priority number first, and returns so
+// operator new tries again. When nothing is left
+// to trim it lifts the soft limit, and only after
+// that does new throw bad_alloc.
+// The soft limit is RLIMIT_AS: allocations past
+// it fail early and trigger the trimming well
+// before the machine itself runs out.
+// The handler runs on whichever thread ran out.
+// A Cache is trimmed only on the thread that
+// created it unless it is constructed with
+// anyThread true, which promises that its
+// trim() does its own locking.
+#ifndef MEMORYPRESSURE_H
+#define MEMORYPRESSURE_H
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <sys/resource.h>
+
+class MemoryPressure {
+public:
+  class Cache {
+    int priority;
+    Cache* next;
+    std::thread::id owner;
+    bool anyThread;
+    friend class MemoryPressure;
+    Cache(const Cache&);
+    void operator=(const Cache&);
+  public:
+    Cache(int prio = 0, bool any = false)
+      : priority(prio), next(0),
+        owner(std::this_thread::get_id()),
+        anyThread(any) {
+      MemoryPressure::add(this);
+    }
+    virtual ~Cache() { MemoryPressure::remove(this); }
+    // Free memory without allocating; runs on the
+    // thread that ran out. Returns bytes freed.
+    virtual std::size_t trim() = 0;
+  };
+  // For anything with a trim() of its own
+  // (NodePool, Arena, PStash in TPStash3.h):
+  template<class T>
+  class Trimmer : public Cache {
+    T& t;
+  public:
+    Trimmer(T& tt, int prio = 0,
+      bool anyThread = false)
+      : Cache(prio, anyThread), t(tt) {}
+    std::size_t trim() { return t.trim(); }
+  };
+private:
+  struct State {
+    std::mutex lock;
+    Cache* caches; // Sorted by priority
+    long trims;
+    std::size_t released;
+    bool limited;
+    State() : caches(0), trims(0), released(0),
+      limited(false) {}
+  };
+  static State& state() {
+    static State s;
+    return s;
+  }
+  static void add(Cache* c) {
+    State& s = state();
+    std::lock_guard<std::mutex> guard(s.lock);
+    Cache** link = &s.caches;
+    while(*link && (*link)->priority <= c->priority)
+      link = &(*link)->next;
+    c->next = *link;
+    *link = c;
+  }
+  static void remove(Cache* c) {
+    State& s = state();
+    std::lock_guard<std::mutex> guard(s.lock);
+    for(Cache** link = &s.caches; *link;
+      link = &(*link)->next)
+      if(*link == c) {
+        *link = c->next;
+        return;
+      }
+  }
+  static bool liftLimit() {
+    State& s = state();
+    rlimit rl;
+    if(!s.limited || getrlimit(RLIMIT_AS, &rl) != 0 ||
+      rl.rlim_cur == rl.rlim_max)
+      return false;
+    s.limited = false;
+    rl.rlim_cur = rl.rlim_max;
+    return setrlimit(RLIMIT_AS, &rl) == 0;
+  }
+  static void handler() {
+    State& s = state();
+    {
+      std::lock_guard<std::mutex> guard(s.lock);
+      std::thread::id me = std::this_thread::get_id();
+      for(Cache* c = s.caches; c; c = c->next) {
+        if(!c->anyThread && c->owner != me)
+          continue; // Another thread's to trim
+        std::size_t freed = c->trim();
+        if(freed > 0) {
+          s.trims++;
+          s.released += freed;
+          return; // operator new retries
+        }
+      }
+      if(liftLimit())
+        return;
+    }
+    throw std::bad_alloc();
+  }
+public:
+  static void install() {
+    std::set_new_handler(handler);
+  }
+  // Cap the address space at bytes, below the
+  // hard limit so it can be lifted again:
+  static bool setSoftLimit(std::size_t bytes) {
+    rlimit rl;
+    if(getrlimit(RLIMIT_AS, &rl) != 0)
+      return false;
+    if(rl.rlim_max != RLIM_INFINITY &&
+      bytes > rl.rlim_max)
+      bytes = rl.rlim_max;
+    rl.rlim_cur = bytes;
+    if(setrlimit(RLIMIT_AS, &rl) != 0)
+      return false;
+    std::lock_guard<std::mutex> guard(state().lock);
+    state().limited = true;
+    return true;
+  }
+  // Caches that gave memory back, and how much:
+  static long trims() { return state().trims; }
+  static std::size_t released() {
+    return state().released;
+  }
+  // False once the handler has lifted it:
+  static bool softLimitActive() {
+    std::lock_guard<std::mutex> guard(state().lock);
+    return state().limited;
+  }
+};
+#endif // MEMORYPRESSURE_H ///:~
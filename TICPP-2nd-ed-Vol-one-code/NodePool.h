@@ -0,0 +1,163 @@
+//: :NodePool.h
+// Node allocators for the linked Stacks. Each
+// stack owns a NodePool: Links are carved from
+// slabs and recycled through an intrusive
+// freelist, so push/pop churn never reaches the
+// global allocator. HeapNodes has the same
+// interface using plain new and delete.
+#ifndef NODEPOOL_H
+#define NODEPOOL_H
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+template<class Node>
+class NodePool {
+  union Block {
+    Block* nextFree; // While on the freelist
+    alignas(Node) unsigned char bytes[sizeof(Node)];
+  };
+  // blocks[0] of each slab links the slab chain:
+  Block* slabs;
+  Block* freeList;
+  int perSlab;
+  int live; // Nodes handed out and not returned
+  void addSlab() {
+    Block* slab = new Block[perSlab + 1];
+    slab[0].nextFree = slabs;
+    slabs = slab;
+    for(int i = perSlab; i > 0; i--) {
+      slab[i].nextFree = freeList;
+      freeList = &slab[i];
+    }
+  }
+  bool inSlab(Block* b, Block* slab) const {
+    std::uintptr_t p = std::uintptr_t(b);
+    return p > std::uintptr_t(slab) &&
+      p <= std::uintptr_t(slab + perSlab);
+  }
+  // A list linked through nextFree (slabs are
+  // linked through their blocks[0]) sorted by
+  // address in place: a bottom-up merge sort.
+  static Block* sorted(Block* list) {
+    for(std::size_t run = 1; ; run *= 2) {
+      Block* p = list;
+      Block** tail = &list;
+      int merges = 0;
+      while(p) {
+        merges++;
+        Block* q = p;
+        std::size_t pn = 0, qn = run;
+        for(; pn < run && q; pn++) q = q->nextFree;
+        while(pn > 0 || (qn > 0 && q)) {
+          Block* e;
+          if(pn > 0 && (qn == 0 || !q ||
+            std::uintptr_t(p) < std::uintptr_t(q))) {
+            e = p;
+            p = p->nextFree;
+            pn--;
+          } else {
+            e = q;
+            q = q->nextFree;
+            qn--;
+          }
+          *tail = e;
+          tail = &e->nextFree;
+        }
+        p = q;
+      }
+      *tail = 0;
+      if(merges <= 1) return list;
+    }
+  }
+  NodePool(const NodePool&);
+  void operator=(const NodePool&);
+public:
+  NodePool(int nodesPerSlab = 64)
+    : slabs(0), freeList(0),
+    perSlab(nodesPerSlab), live(0) {}
+  ~NodePool() { reset(); } // Nodes die with their stack
+  void* allocate() {
+    if(freeList == 0) addSlab();
+    Block* b = freeList;
+    freeList = b->nextFree;
+    live++;
+    return b;
+  }
+  void deallocate(void* p) {
+    Block* b = static_cast<Block*>(p);
+    b->nextFree = freeList;
+    freeList = b;
+    live--;
+  }
+  template<class... Args>
+  Node* create(Args&&... args) {
+    return new(allocate())
+      Node(std::forward<Args>(args)...);
+  }
+  void destroy(Node* n) {
+    n->~Node();
+    deallocate(n);
+  }
+  int inUse() const { return live; }
+  // Return every slab to the heap; only legal
+  // when no node is in use:
+  void release() {
+    if(live != 0) return;
+    while(slabs) {
+      Block* next = slabs[0].nextFree;
+      delete []slabs;
+      slabs = next;
+    }
+    freeList = 0;
+  }
+  // Free the slabs none of whose nodes are in
+  // use; returns the bytes released. Both the
+  // slabs and the freelist are sorted by address
+  // first, so each slab's free nodes are found in
+  // one walk. Allocates nothing, so a new_handler
+  // may call it -- but only on the thread that
+  // owns the pool, as nothing here is locked.
+  std::size_t trim() {
+    slabs = sorted(slabs);
+    freeList = sorted(freeList);
+    std::size_t released = 0;
+    Block** link = &slabs;
+    Block** f = &freeList;
+    while(*link) {
+      Block* slab = *link;
+      Block** first = f;
+      int free = 0;
+      for(; *f && inSlab(*f, slab); f = &(*f)->nextFree)
+        free++;
+      if(free < perSlab) {
+        link = &slab[0].nextFree;
+        continue;
+      }
+      *first = *f; // Drop this slab's nodes
+      f = first;
+      *link = slab[0].nextFree;
+      delete []slab;
+      released += (perSlab + 1) * sizeof(Block);
+    }
+    return released;
+  }
+  // Free every slab even with nodes in use; the
+  // owner has already destroyed them:
+  void reset() {
+    live = 0;
+    release();
+  }
+};
+
+template<class Node>
+class HeapNodes {
+public:
+  template<class... Args>
+  Node* create(Args&&... args) {
+    return new Node(std::forward<Args>(args)...);
+  }
+  void destroy(Node* n) { delete n; }
+};
+#endif // NODEPOOL_H ///:~
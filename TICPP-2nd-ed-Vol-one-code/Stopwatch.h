@@ -0,0 +1,25 @@
+//: :Stopwatch.h
+// Wall-clock timer for the timing programs
+#ifndef STOPWATCH_H
+#define STOPWATCH_H
+#include <chrono>
+
+class Stopwatch {
+  std::chrono::steady_clock::time_point start;
+public:
+  Stopwatch() { mark(); }
+  void mark() {
+    start = std::chrono::steady_clock::now();
+  }
+  // Elapsed time since construction or mark():
+  double seconds() const {
+    return std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start)
+      .count();
+  }
+  double nanosPer(long operations) const {
+    return operations > 0 ?
+      seconds() * 1e9 / operations : 0;
+  }
+};
+#endif // STOPWATCH_H ///:~
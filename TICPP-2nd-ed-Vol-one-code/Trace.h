@@ -0,0 +1,145 @@
+//: :Trace.h
+// Tracing that costs nothing when it is off.
+// TRACE(a << b) is chosen at compile time by
+// TRACE_LEVEL:
+//   0 (traceOff): expands to nothing, so the
+//     arguments are not even evaluated; the
+//     default when NDEBUG is defined
+//   1 (traceRing): formats the line into a slot
+//     of a fixed ring buffer claimed with one
+//     atomic increment, with no lock, heap or
+//     I/O; the buffer is printed to sink() at
+//     exit, so sink() must outlive main(). Lines
+//     come out after anything printed with cout
+//     and only the last ringSize are kept; the
+//     default otherwise
+//   2 (traceStream): the old behavior, one line
+//     to Trace::sink() (cout unless changed) as
+//     it happens
+// Compile with -DTRACE_LEVEL=n to choose. Demos
+// whose output interleaves traces with cout are
+// built with -DTRACE_LEVEL=2 by their makefile
+// rules; every file of a program must agree.
+#ifndef TRACE_H
+#define TRACE_H
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <streambuf>
+
+enum { traceOff, traceRing, traceStream };
+
+#ifndef TRACE_LEVEL
+#ifdef NDEBUG
+#define TRACE_LEVEL 0
+#else
+#define TRACE_LEVEL 1
+#endif
+#endif
+
+class Trace {
+public:
+  enum { ringSize = 1024, lineSize = 120 };
+  static const int level = TRACE_LEVEL;
+private:
+  struct Slot {
+    std::atomic<unsigned long> seq; // Line number + 1
+    char text[lineSize];
+  };
+  struct Ring {
+    std::atomic<unsigned long> head;
+    Slot slots[ringSize];
+  };
+  static void dumpAtExit() { dump(*sink()); }
+  static Ring& ring() {
+    static Ring r; // Zero-initialized
+    static bool atExit =
+      (std::atexit(dumpAtExit), true);
+    (void)atExit;
+    return r;
+  }
+  // Writes into a slot, cutting long lines:
+  class SlotBuf : public std::streambuf {
+  public:
+    SlotBuf(char* text) {
+      setp(text, text + lineSize - 1);
+    }
+    std::size_t length() const {
+      return pptr() - pbase();
+    }
+  };
+public:
+  // One ring-buffer line; TRACE makes these
+  class Line {
+    unsigned long n; // Set by claim()
+    Slot& slot;
+    SlotBuf buf;
+    std::ostream& out;
+    std::streambuf* outer; // A TRACE in a TRACE
+  public:
+    Line() : slot(claim(n)), buf(slot.text),
+      out(stream()), outer(out.rdbuf(&buf)) {}
+    ~Line() {
+      out.rdbuf(outer);
+      slot.text[buf.length()] = 0;
+      slot.seq.store(n + 1,
+        std::memory_order_release);
+    }
+    std::ostream& os() { return out; }
+  private:
+    // Building an ostream costs more than the
+    // line; each thread reuses one:
+    static std::ostream& stream() {
+      static thread_local std::ostream os(0);
+      return os;
+    }
+    static Slot& claim(unsigned long& n) {
+      Ring& r = ring();
+      n = r.head.fetch_add(1,
+        std::memory_order_relaxed);
+      Slot& s = r.slots[n % ringSize];
+      s.seq.store(0, std::memory_order_relaxed);
+      return s;
+    }
+  };
+  static std::ostream*& sink() {
+    static std::ostream* os = &std::cout;
+    return os;
+  }
+  // The last ringSize lines, oldest first. Lines
+  // still being written are skipped.
+  static void dump(std::ostream& os) {
+    Ring& r = ring();
+    unsigned long end = r.head.load();
+    unsigned long begin =
+      end > ringSize ? end - ringSize : 0;
+    char text[lineSize];
+    for(unsigned long i = begin; i < end; i++) {
+      Slot& s = r.slots[i % ringSize];
+      if(s.seq.load(std::memory_order_acquire)
+        != i + 1) continue;
+      std::memcpy(text, s.text, lineSize);
+      if(s.seq.load(std::memory_order_acquire)
+        != i + 1) continue; // Overwritten meanwhile
+      text[lineSize - 1] = 0;
+      os << text << std::endl;
+    }
+  }
+  static unsigned long lines() {
+    return ring().head.load();
+  }
+};
+
+#if TRACE_LEVEL == 0 // traceOff
+#define TRACE(msg) ((void)0)
+#elif TRACE_LEVEL == 1 // traceRing
+#define TRACE(msg) \
+  do { Trace::Line traceLine_; \
+    traceLine_.os() << msg; } while(0)
+#else
+#define TRACE(msg) \
+  do { *Trace::sink() << msg << std::endl; } \
+  while(0)
+#endif
+#endif // TRACE_H ///:~
@@ -0,0 +1,300 @@
+//: :WordCount.h
+// Word frequencies for text of any size, using
+// every core. The text is cut into one chunk per
+// thread at whitespace, each thread counts its
+// chunk with Words (see Words.h) into tables of
+// its own, one per partition of the hash, and
+// the tables are merged in parallel: thread t
+// merges only the partition t tables, so each
+// thread's share of the merge shrinks as
+// threads are added. No table is shared while
+// it is written, so nothing is locked.
+// The counted words are views into the text,
+// which must outlive the WordCount.
+//   WordCount wc(file.data(), file.size());
+//   wc["radius"]; wc.top(10);
+// WordCount::occurrences() counts one word
+// without hashing at all.
+#ifndef WORDCOUNT_H
+#define WORDCOUNT_H
+#include "Words.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Open addressing with linear probing; the
+// capacity is a power of two kept at least
+// twice the number of words. Each entry keeps
+// the first 8 bytes of its word, so short words
+// are compared without reading the text again.
+class WordTable {
+public:
+  struct Entry {
+    std::string_view word; // data() == 0: empty
+    std::uint64_t hash;
+    std::uint64_t head; // First 8 bytes
+    long count;
+  };
+private:
+  std::vector<Entry> slots;
+  std::size_t used;
+  void grow() {
+    std::vector<Entry> old(slots.size() * 2);
+    old.swap(slots);
+    used = 0;
+    for(std::size_t i = 0; i < old.size(); i++)
+      if(old[i].word.data())
+        add(old[i].word, old[i].hash,
+          old[i].count);
+  }
+public:
+  explicit WordTable(std::size_t capacity = 1024)
+    : used(0) {
+    std::size_t c = 16;
+    while(c < capacity) c *= 2;
+    slots.resize(c);
+  }
+  static std::uint64_t head(std::string_view w) {
+    std::uint64_t x = 0;
+    std::memcpy(&x, w.data(), std::min(w.size(),
+      sizeof x));
+    return x;
+  }
+  static bool same(const Entry& e,
+    std::string_view w, std::uint64_t h) {
+    return e.hash == h &&
+      e.word.size() == w.size() &&
+      e.head == head(w) && (w.size() <= 8 ||
+        std::memcmp(e.word.data() + 8,
+          w.data() + 8, w.size() - 8) == 0);
+  }
+  static std::uint64_t hash(std::string_view w) {
+    const char* s = w.data();
+    std::size_t n = w.size();
+    std::uint64_t h = 0x9e3779b97f4a7c15ULL ^ n;
+    for(; n >= 8; s += 8, n -= 8) {
+      std::uint64_t x;
+      std::memcpy(&x, s, 8);
+      h = (h ^ x) * 0xff51afd7ed558ccdULL;
+      h ^= h >> 32;
+    }
+    if(n > 0) {
+      std::uint64_t x = 0;
+      std::memcpy(&x, s, n);
+      h = (h ^ x) * 0xc4ceb9fe1a85ec53ULL;
+    }
+    return h ^ (h >> 29);
+  }
+  void add(std::string_view w, std::uint64_t h,
+    long count = 1) {
+    std::size_t mask = slots.size() - 1;
+    for(std::size_t i = h & mask; ;
+      i = (i + 1) & mask) {
+      Entry& e = slots[i];
+      if(e.word.data() == 0) {
+        e.word = w;
+        e.hash = h;
+        e.head = head(w);
+        e.count = count;
+        if(++used * 2 > slots.size()) grow();
+        return;
+      }
+      if(same(e, w, h)) {
+        e.count += count;
+        return;
+      }
+    }
+  }
+  void add(std::string_view w) { add(w, hash(w)); }
+  long find(std::string_view w,
+    std::uint64_t h) const {
+    std::size_t mask = slots.size() - 1;
+    for(std::size_t i = h & mask; ;
+      i = (i + 1) & mask) {
+      const Entry& e = slots[i];
+      if(e.word.data() == 0) return 0;
+      if(same(e, w, h)) return e.count;
+    }
+  }
+  // Start loading h's slot into the cache:
+  void prefetch(std::uint64_t h) const {
+    __builtin_prefetch(
+      &slots[h & (slots.size() - 1)]);
+  }
+  std::size_t size() const { return used; }
+  // Every slot; skip those with no word:
+  const std::vector<Entry>& entries() const {
+    return slots;
+  }
+};
+
+class WordCount {
+public:
+  typedef std::pair<std::string_view, long> Freq;
+private:
+  std::vector<WordTable> parts; // Disjoint
+  long words;
+  // Which of n partitions holds a hash:
+  static std::size_t part(std::uint64_t h,
+    std::size_t n) {
+    return (h >> 40) % n;
+  }
+  static bool isSpace(char c) {
+    return c == ' ' || unsigned(c - '\t') <= 4;
+  }
+  // Most adds miss the cache, so each word's
+  // slot is prefetched and the word is added a
+  // few words later, when the slot has arrived:
+  static long countChunk(const char* text,
+    std::size_t n, WordTable* table, int parts) {
+    enum { ahead = 8 };
+    std::string_view word[ahead];
+    std::uint64_t hash[ahead];
+    Words in(text, n);
+    std::string_view w;
+    long count = 0;
+    while(in >> w) {
+      int i = count++ % ahead;
+      if(count > ahead)
+        table[part(hash[i], parts)].add(word[i],
+          hash[i]);
+      word[i] = w;
+      hash[i] = WordTable::hash(w);
+      table[part(hash[i], parts)].prefetch(hash[i]);
+    }
+    for(long c = std::max(0L, count - ahead);
+      c < count; c++) {
+      int i = c % ahead;
+      table[part(hash[i], parts)].add(word[i],
+        hash[i]);
+    }
+    return count;
+  }
+public:
+  // Run f(0) ... f(n - 1) on n threads:
+  template<class F>
+  static void inParallel(int n, F f) {
+    std::vector<std::thread> threads;
+    for(int t = 1; t < n; t++)
+      threads.push_back(std::thread(f, t));
+    f(0); // This thread takes a share too
+    for(std::size_t t = 0; t < threads.size(); t++)
+      threads[t].join();
+  }
+  static int defaultThreads() {
+    int n = std::thread::hardware_concurrency();
+    return n > 0 ? n : 1;
+  }
+  // Chunk boundaries: n / parts apart, each
+  // moved forward to whitespace so no word is
+  // cut in two.
+  static std::vector<std::size_t> chunks(
+    const char* text, std::size_t n, int parts) {
+    std::vector<std::size_t> cuts(1, 0);
+    for(int i = 1; i < parts; i++) {
+      std::size_t c = std::max(cuts.back(),
+        std::size_t(double(n) * i / parts));
+      while(c < n && !isSpace(text[c])) c++;
+      cuts.push_back(c);
+    }
+    cuts.push_back(n);
+    return cuts;
+  }
+  WordCount(const char* text, std::size_t n,
+    int threads = defaultThreads())
+    : words(0) {
+    if(threads < 1) threads = 1;
+    std::vector<std::size_t> cuts =
+      chunks(text, n, threads);
+    // Thread t's table for partition p is
+    // local[t * threads + p]:
+    std::vector<WordTable> local(
+      std::size_t(threads) * threads,
+      WordTable(std::max(16, 1024 / threads)));
+    std::vector<long> seen(threads, 0);
+    inParallel(threads, [&](int t) {
+      seen[t] = countChunk(text + cuts[t],
+        cuts[t + 1] - cuts[t],
+        &local[std::size_t(t) * threads], threads);
+    });
+    parts.resize(threads);
+    inParallel(threads, [&](int t) {
+      WordTable& mine = parts[t];
+      mine = std::move(local[t]); // Thread 0's
+      for(int s = 1; s < threads; s++) {
+        const std::vector<WordTable::Entry>& e =
+          local[std::size_t(s) * threads + t]
+            .entries();
+        for(std::size_t i = 0; i < e.size(); i++)
+          if(e[i].word.data())
+            mine.add(e[i].word, e[i].hash,
+              e[i].count);
+      }
+    });
+    for(int t = 0; t < threads; t++)
+      words += seen[t];
+  }
+  long operator[](std::string_view w) const {
+    std::uint64_t h = WordTable::hash(w);
+    return parts[part(h, parts.size())].find(w, h);
+  }
+  long total() const { return words; }
+  std::size_t distinct() const {
+    std::size_t d = 0;
+    for(std::size_t t = 0; t < parts.size(); t++)
+      d += parts[t].size();
+    return d;
+  }
+  // The k most frequent words, most frequent
+  // first, equal counts in alphabetical order:
+  std::vector<Freq> top(std::size_t k) const {
+    std::vector<Freq> all;
+    all.reserve(distinct());
+    for(std::size_t t = 0; t < parts.size(); t++) {
+      const std::vector<WordTable::Entry>& e =
+        parts[t].entries();
+      for(std::size_t i = 0; i < e.size(); i++)
+        if(e[i].word.data())
+          all.push_back(Freq(e[i].word, e[i].count));
+    }
+    k = std::min(k, all.size());
+    std::partial_sort(all.begin(), all.begin() + k,
+      all.end(), [](const Freq& a, const Freq& b) {
+        return a.second != b.second ?
+          a.second > b.second : a.first < b.first;
+      });
+    all.resize(k);
+    return all;
+  }
+  // How often word occurs: the same chunks, but
+  // each word is only compared with the target.
+  static long occurrences(const char* text,
+    std::size_t n, std::string_view word,
+    int threads = defaultThreads()) {
+    if(threads < 1) threads = 1;
+    std::vector<std::size_t> cuts =
+      chunks(text, n, threads);
+    std::vector<long> found(threads, 0);
+    inParallel(threads, [&](int t) {
+      Words in(text + cuts[t],
+        cuts[t + 1] - cuts[t]);
+      std::string_view w;
+      long count = 0;
+      while(in >> w)
+        count += (w.size() == word.size() &&
+          std::memcmp(w.data(), word.data(),
+            w.size()) == 0);
+      found[t] = count;
+    });
+    long total = 0;
+    for(int t = 0; t < threads; t++)
+      total += found[t];
+    return total;
+  }
+};
+#endif // WORDCOUNT_H ///:~
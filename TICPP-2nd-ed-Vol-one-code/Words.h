@@ -0,0 +1,170 @@
+//: :Words.h
+// Splits a block of text into whitespace-
+// separated words, the same words `in >> word`
+// reads, but each word is a string_view into
+// the text: nothing is copied or allocated.
+// Whitespace is found 64 bytes at a time as a
+// bitmask, with AVX2 or SSE2 where the CPU has
+// them and plain C++ otherwise. From it come a
+// mask of word starts and a mask of word ends
+// for the block, and each word is then two
+// counts of trailing zero bits.
+//   Words in(text, size);
+//   std::string_view word;
+//   while(in >> word) ...
+#ifndef WORDS_H
+#define WORDS_H
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#if defined(__x86_64__) || defined(__i386__)
+#define WORDS_X86
+#include <immintrin.h>
+#endif
+
+class Words {
+public:
+  enum Isa { scalar, sse2, avx2, best };
+  typedef std::uint64_t (*MaskFn)(const char*);
+private:
+  const char* p;
+  std::size_t n;
+  std::size_t base; // Start of the current block
+  std::uint64_t space; // Bit i: p[base + i]
+  std::uint64_t starts, ends; // Not yet read
+  bool ok;
+  MaskFn mask;
+  // ' ', \t, \n, \v, \f and \r, as isspace() has
+  // them in the "C" locale:
+  static bool isSpace(unsigned char c) {
+    return c == ' ' || unsigned(c - '\t') <= 4;
+  }
+  static std::uint64_t maskScalar(const char* s) {
+    std::uint64_t m = 0;
+    for(int i = 0; i < 64; i++)
+      m |= std::uint64_t(isSpace(s[i])) << i;
+    return m;
+  }
+#ifdef WORDS_X86
+  __attribute__((target("sse2")))
+  static std::uint64_t maskSSE2(const char* s) {
+    const __m128i blank = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i four = _mm_set1_epi8(4);
+    std::uint64_t m = 0;
+    for(int i = 0; i < 4; i++) {
+      __m128i v = _mm_loadu_si128(
+        (const __m128i*)(s + 16 * i));
+      // c - '\t' <= 4, unsigned:
+      __m128i t = _mm_sub_epi8(v, tab);
+      __m128i ctl = _mm_cmpeq_epi8(
+        _mm_min_epu8(t, four), t);
+      __m128i sp = _mm_or_si128(ctl,
+        _mm_cmpeq_epi8(v, blank));
+      m |= std::uint64_t(unsigned(
+        _mm_movemask_epi8(sp))) << (16 * i);
+    }
+    return m;
+  }
+  __attribute__((target("avx2")))
+  static std::uint64_t maskAVX2(const char* s) {
+    const __m256i blank = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i four = _mm256_set1_epi8(4);
+    std::uint64_t m = 0;
+    for(int i = 0; i < 2; i++) {
+      __m256i v = _mm256_loadu_si256(
+        (const __m256i*)(s + 32 * i));
+      __m256i t = _mm256_sub_epi8(v, tab);
+      __m256i ctl = _mm256_cmpeq_epi8(
+        _mm256_min_epu8(t, four), t);
+      __m256i sp = _mm256_or_si256(ctl,
+        _mm256_cmpeq_epi8(v, blank));
+      m |= std::uint64_t(unsigned(
+        _mm256_movemask_epi8(sp))) << (32 * i);
+    }
+    return m;
+  }
+#endif
+  void load(std::size_t b) {
+    // Was the byte before b whitespace?
+    std::uint64_t carry = space >> 63;
+    base = b;
+    if(b + 64 <= n)
+      space = mask(p + b);
+    else if(b >= n)
+      space = ~std::uint64_t(0);
+    else {
+      // Past the end counts as whitespace:
+      char tail[64];
+      std::memset(tail, ' ', sizeof tail);
+      std::memcpy(tail, p + b, n - b);
+      space = mask(tail);
+    }
+    std::uint64_t before = (space << 1) | carry;
+    starts = ~space & before;
+    ends = space & ~before; // One past a word
+  }
+public:
+  Words(const char* text, std::size_t size,
+    Isa isa = best)
+    : p(text), n(size), base(0),
+    space(~std::uint64_t(0)), starts(0), ends(0),
+    ok(true), mask(maskFor(isa)) {
+    load(0);
+  }
+  explicit Words(std::string_view text,
+    Isa isa = best)
+    : Words(text.data(), text.size(), isa) {}
+  // Next word, or fail like an istream at the
+  // end of the text:
+  Words& operator>>(std::string_view& word) {
+    while(starts == 0) {
+      if(base + 64 >= n) {
+        ok = false;
+        return *this;
+      }
+      load(base + 64);
+    }
+    std::size_t start =
+      base + __builtin_ctzll(starts);
+    starts &= starts - 1;
+    // Words end in the order they start, so the
+    // lowest end bit left is this word's:
+    while(ends == 0)
+      load(base + 64);
+    std::size_t end = base + __builtin_ctzll(ends);
+    ends &= ends - 1;
+    word = std::string_view(p + start, end - start);
+    return *this;
+  }
+  explicit operator bool() const { return ok; }
+  // The widest instruction set this CPU has:
+  static Isa detect() {
+#ifdef WORDS_X86
+    if(__builtin_cpu_supports("avx2"))
+      return avx2;
+    if(__builtin_cpu_supports("sse2"))
+      return sse2;
+#endif
+    return scalar;
+  }
+  // isa, or the best the CPU has if it hasn't
+  // got isa:
+  static MaskFn maskFor(Isa isa) {
+    Isa have = detect();
+    if(isa > have) isa = have;
+#ifdef WORDS_X86
+    if(isa == avx2) return maskAVX2;
+    if(isa == sse2) return maskSSE2;
+#endif
+    return maskScalar;
+  }
+  static const char* name(Isa isa) {
+    static const char* names[] =
+      { "scalar", "SSE2", "AVX2", "best" };
+    return names[isa];
+  }
+};
+#endif // WORDS_H ///:~